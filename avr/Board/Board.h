@@ -60,10 +60,10 @@
 	/* Public Interface - May be used in end-application: */
 		/* Macros: */
 			/** Indicates the board has hardware Buttons mounted if defined. */
-//			#define BOARD_HAS_BUTTONS
+			#define BOARD_HAS_BUTTONS
 
 			/** Indicates the board has a hardware Dataflash mounted if defined. */
-//			#define BOARD_HAS_DATAFLASH
+			#define BOARD_HAS_DATAFLASH
 
 			/** Indicates the board has a hardware Joystick mounted if defined. */
 //			#define BOARD_HAS_JOYSTICK
@@ -29,23 +29,24 @@
 */
 
 /** \file
- *  \brief LUFA Custom Board Button Hardware Driver (Template)
+ *  \brief Board specific Buttons driver header for the WebRadio front panel.
  *
- *  This is a stub driver header file, for implementing custom board
- *  layout hardware with compatible LUFA board specific drivers. If
- *  the library is configured to use the BOARD_USER board mode, this
- *  driver file should be completed and copied into the "/Board/" folder
- *  inside the application's folder.
+ *  The front panel keys are wired as a matrix of \ref BUTTONS_ROWS rows and \ref BUTTONS_COLUMNS columns, each
+ *  on consecutive pins of one port as given by the board pin map in Board/Pins.h. A row is selected by driving it low, all other rows are left floating, and a pressed key
+ *  pulls its column low against the internal pull-up.
  *
- *  This stub is for the board-specific component of the LUFA Buttons driver,
- *  for the control of physical board-mounted GPIO pushbuttons.
+ *  The application reads the whole matrix with \ref Buttons_GetStatus() on every timer tick, which selects each row
+ *  in turn with \ref Buttons_SelectRow() and reads it with \ref Buttons_ReadRow() once the column lines have
+ *  settled. The status is not debounced, the key scanner in Driver/keys.c debounces it over four ticks.
  */
 
 #ifndef __BUTTONS_USER_H__
 #define __BUTTONS_USER_H__
 
 	/* Includes: */
-		// TODO: Add any required includes here
+		#include <avr/io.h>
+
+		#include "Pins.h"
 
 	/* Enable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
@@ -57,30 +58,88 @@
 			#error Do not include this file directly. Include LUFA/Drivers/Board/Buttons.h instead.
 		#endif
 
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define BUTTONS_ROW_PORT      PIN_KEY_ROW1_PORT
+			#define BUTTONS_ROW_SHIFT     PIN_KEY_ROW1_BIT
+			#define BUTTONS_ROW_MASK      (((1 << BUTTONS_ROWS) - 1) << BUTTONS_ROW_SHIFT)
+			#define BUTTONS_COLUMN_PORT   PIN_KEY_COL1_PORT
+			#define BUTTONS_COLUMN_SHIFT  PIN_KEY_COL1_BIT
+			#define BUTTONS_COLUMN_MASK   (((1 << BUTTONS_COLUMNS) - 1) << BUTTONS_COLUMN_SHIFT)
+	#endif
+
 	/* Public Interface - May be used in end-application: */
 		/* Macros: */
-			/** Button mask for the first button on the board. */
-			#define BUTTONS_BUTTON1          // TODO: Add mask for first board button here
+			/** Number of key matrix rows, on consecutive pins from KEY_ROW1 upwards. */
+			#define BUTTONS_ROWS             2
+
+			/** Number of key matrix columns, on consecutive pins from KEY_COL1 upwards. */
+			#define BUTTONS_COLUMNS          4
+
+			/** Button mask for the first button on the board, row 1 column 1. Button N is (BUTTONS_BUTTON1 << (N - 1)),
+			 *  numbered along the rows.
+			 */
+			#define BUTTONS_BUTTON1          (1 << 0)
 
 		/* Inline Functions: */
 		#if !defined(__DOXYGEN__)
 			static inline void Buttons_Init(void)
 			{
-				// TODO: Initialize the appropriate port pins as an inputs here, with pull-ups
+				Board_SetInputs(BUTTONS_COLUMN_PORT, BUTTONS_COLUMN_MASK);
+				Board_SetPins(BUTTONS_COLUMN_PORT, BUTTONS_COLUMN_MASK);
+				Board_SetInputs(BUTTONS_ROW_PORT, BUTTONS_ROW_MASK);
+				Board_ClearPins(BUTTONS_ROW_PORT, BUTTONS_ROW_MASK);
 			}
 
 			static inline void Buttons_Disable(void)
 			{
-				// TODO: Clear the appropriate port pins as high impedance inputs here
+				Board_SetInputs(BUTTONS_COLUMN_PORT, BUTTONS_COLUMN_MASK);
+				Board_ClearPins(BUTTONS_COLUMN_PORT, BUTTONS_COLUMN_MASK);
+				Board_SetInputs(BUTTONS_ROW_PORT, BUTTONS_ROW_MASK);
+				Board_ClearPins(BUTTONS_ROW_PORT, BUTTONS_ROW_MASK);
+			}
+
+			static inline void Buttons_SelectRow(const uint8_t Row)
+			{
+				Board_ChangeOutputs(BUTTONS_ROW_PORT, BUTTONS_ROW_MASK, (1 << (Row + BUTTONS_ROW_SHIFT)));
+			}
+
+			static inline uint8_t Buttons_ReadRow(void) ATTR_WARN_UNUSED_RESULT;
+			static inline uint8_t Buttons_ReadRow(void)
+			{
+				return ((~BOARD_PINREG(BUTTONS_COLUMN_PORT) & BUTTONS_COLUMN_MASK) >> BUTTONS_COLUMN_SHIFT);
 			}
 
 			static inline uint8_t Buttons_GetStatus(void) ATTR_WARN_UNUSED_RESULT;
 			static inline uint8_t Buttons_GetStatus(void)
 			{
-				// TODO: Return current button status here, debounced if required
+				uint8_t Status = 0;
+
+				for (uint8_t Row = 0; Row < BUTTONS_ROWS; Row++)
+				{
+					Buttons_SelectRow(Row);
+
+					/* Give the column lines time to settle */
+					__builtin_avr_delay_cycles(16);
+
+					Status |= (Buttons_ReadRow() << (Row * BUTTONS_COLUMNS));
+				}
+
+				Board_SetInputs(BUTTONS_ROW_PORT, BUTTONS_ROW_MASK);
+
+				return Status;
 			}
 		#endif
 
+	/* Compile Time Checks: */
+		_Static_assert(BOARD_GROUP_SIZE(BOARD_KEY_ROWS) == BUTTONS_ROWS, "the pin map lists one pin per key row");
+		_Static_assert(BOARD_GROUP_SIZE(BOARD_KEY_COLUMNS) == BUTTONS_COLUMNS, "the pin map lists one pin per key column");
+		_Static_assert(BOARD_GROUP_MASK(BOARD_KEY_ROWS, BUTTONS_ROW_PORT) == BUTTONS_ROW_MASK,
+		               "the key rows are on consecutive pins of one port");
+		_Static_assert(BOARD_GROUP_MASK(BOARD_KEY_COLUMNS, BUTTONS_COLUMN_PORT) == BUTTONS_COLUMN_MASK,
+		               "the key columns are on consecutive pins of one port");
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
@@ -29,23 +29,22 @@
 */
 
 /** \file
- *  \brief LUFA Custom Board Dataflash Hardware Driver (Template)
+ *  \brief Board specific Dataflash driver header for the WebRadio board.
  *
- *  This is a stub driver header file, for implementing custom board
- *  layout hardware with compatible LUFA board specific drivers. If
- *  the library is configured to use the BOARD_USER board mode, this
- *  driver file should be completed and copied into the "/Board/" folder
- *  inside the application's folder.
- *
- *  This stub is for the board-specific component of the LUFA Dataflash
- *  driver.
+ *  The board carries a single AT45DB041D (2048 pages of 264 bytes, same command set as the AT45DB161D) with its
+ *  /CS on the FLASH_CS pin of the board pin map. It shares the SPI bus with the PT6524 display driver, which owns
+ *  the SPI interrupt, so the SPI interrupt must be disabled while the Dataflash is accessed, see
+ *  \ref pt6524_bus_acquire().
 */
 
 #ifndef __DATAFLASH_USER_H__
 #define __DATAFLASH_USER_H__
 
 	/* Includes: */
-		// TODO: Add any required includes here
+		#include <LUFA/Drivers/Peripheral/SPI.h>
+		#include <LUFA/Drivers/Misc/AT45DB161D.h>
+
+		#include "Pins.h"
 
 	/* Preprocessor Checks: */
 		#if !defined(__INCLUDE_FROM_DATAFLASH_H)
@@ -55,30 +54,30 @@
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
 		/* Macros: */
-			#define DATAFLASH_CHIPCS_MASK                // TODO: Replace this with a mask of all the /CS pins of all Dataflashes
-			#define DATAFLASH_CHIPCS_DDR                 // TODO: Replace with the DDR register name for the board's Dataflash ICs
-			#define DATAFLASH_CHIPCS_PORT                // TODO: Replace with the PORT register name for the board's Dataflash ICs
+			#define DATAFLASH_CHIPCS_MASK                PIN_FLASH_CS_MASK
+			#define DATAFLASH_CHIPCS_DDR                 BOARD_DDRREG(PIN_FLASH_CS_PORT)
+			#define DATAFLASH_CHIPCS_PORT                BOARD_PORTREG(PIN_FLASH_CS_PORT)
 	#endif
 
 	/* Public Interface - May be used in end-application: */
 		/* Macros: */
 			/** Constant indicating the total number of dataflash ICs mounted on the selected board. */
-			#define DATAFLASH_TOTALCHIPS                 1 // TODO: Replace with the number of Dataflashes on the board, max 2
+			#define DATAFLASH_TOTALCHIPS                 1
 
 			/** Mask for no dataflash chip selected. */
 			#define DATAFLASH_NO_CHIP                    0
 
 			/** Mask for the first dataflash chip selected. */
-			#define DATAFLASH_CHIP1                      // TODO: Replace with mask with the pin attached to the first Dataflash /CS set
+			#define DATAFLASH_CHIP1                      PIN_FLASH_CS_MASK
 
 			/** Mask for the second dataflash chip selected. */
-			#define DATAFLASH_CHIP2                      // TODO: Replace with mask with the pin attached to the second Dataflash /CS set
+			#define DATAFLASH_CHIP2                      0
 
 			/** Internal main memory page size for the board's dataflash ICs. */
-			#define DATAFLASH_PAGE_SIZE                  // TODO: Replace with the page size for the Dataflash ICs
+			#define DATAFLASH_PAGE_SIZE                  264
 
 			/** Total number of pages inside each of the board's dataflash ICs. */
-			#define DATAFLASH_PAGES                      // TODO: Replace with the total number of pages inside one of the Dataflash ICs
+			#define DATAFLASH_PAGES                      2048
 
 		/* Inline Functions: */
 		#if !defined(__DOXYGEN__)
@@ -100,7 +99,7 @@
 			static inline uint8_t Dataflash_TransferByte(const uint8_t Byte) ATTR_ALWAYS_INLINE;
 			static inline uint8_t Dataflash_TransferByte(const uint8_t Byte)
 			{
-				// TODO
+				return SPI_TransferByte(Byte);
 			}
 
 			/** Sends a byte to the currently selected dataflash IC, and ignores the next byte from the dataflash.
@@ -110,7 +109,7 @@
 			static inline void Dataflash_SendByte(const uint8_t Byte) ATTR_ALWAYS_INLINE;
 			static inline void Dataflash_SendByte(const uint8_t Byte)
 			{
-				// TODO
+				SPI_SendByte(Byte);
 			}
 
 			/** Sends a dummy byte to the currently selected dataflash IC, and returns the next byte from the dataflash.
@@ -120,7 +119,7 @@
 			static inline uint8_t Dataflash_ReceiveByte(void) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
 			static inline uint8_t Dataflash_ReceiveByte(void)
 			{
-				// TODO
+				return SPI_ReceiveByte();
 			}
 
 			/** Determines the currently selected dataflash chip.
@@ -213,8 +212,8 @@
 					PageAddress >>= 1;
 				#endif
 
-				Dataflash_SendByte(PageAddress >> 5);
-				Dataflash_SendByte((PageAddress << 3) | (BufferByte >> 8));
+				Dataflash_SendByte(PageAddress >> 7);
+				Dataflash_SendByte((PageAddress << 1) | (BufferByte >> 8));
 				Dataflash_SendByte(BufferByte);
 			}
 		#endif
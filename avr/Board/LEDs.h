@@ -29,17 +29,14 @@
 */
 
 /** \file
- *  \brief LUFA Custom Board LED Hardware Driver (Template)
+ *  \brief Board specific LED driver header for the WebRadio board.
  *
- *  This is a stub driver header file, for implementing custom board
- *  layout hardware with compatible LUFA board specific drivers. If
- *  the library is configured to use the BOARD_USER board mode, this
- *  driver file should be completed and copied into the "/Board/" folder
- *  inside the application's folder.
+ *  The board has a yellow and a green LED, both active low. Their pins are taken from the board pin map in
+ *  Board/Pins.h; every function below only touches the ports which actually carry an LED.
  *
- *  This stub is for the board-specific component of the LUFA LEDs driver,
- *  for the LEDs (up to four) mounted on most development boards.
-*/
+ *  \note This file should not be included directly. It is automatically included as needed by the LEDs driver
+ *        dispatch header located in LUFA/Drivers/Board/LEDs.h.
+ */
 
 #ifndef __LEDS_USER_H__
 #define __LEDS_USER_H__
@@ -47,6 +44,8 @@
 	/* Includes: */
 		#include "Common/Common.h"
 
+		#include "Pins.h"
+
 	/* Enable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			extern "C" {
@@ -60,17 +59,34 @@
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
 		/* Macros: */
-LEDS_PORTD_LEDS			#define LEDS_PORTB_LEDS       (LEDS_LED1)
-			#define LEDS_PORTD_LEDS       (LEDS_LED2)
+			#define LEDS_ON_PORT(Port)                    BOARD_GROUP_MASK(BOARD_LEDS, Port)
+
+			#define LEDS_PORT_INIT(Port, Unused)          Board_SetOutputs(Port, LEDS_ON_PORT(Port)); \
+			                                              Board_SetPins(Port, LEDS_ON_PORT(Port));
+			#define LEDS_PORT_DISABLE(Port, Unused)       Board_SetInputs(Port, LEDS_ON_PORT(Port)); \
+			                                              Board_ClearPins(Port, LEDS_ON_PORT(Port));
+			#define LEDS_PORT_ON(Port, LEDMask)           Board_ClearPins(Port, ((LEDMask) & LEDS_ON_PORT(Port)));
+			#define LEDS_PORT_OFF(Port, LEDMask)          Board_SetPins(Port, ((LEDMask) & LEDS_ON_PORT(Port)));
+			#define LEDS_PORT_SET(Port, LEDMask)          Board_ChangePins(Port, LEDS_ON_PORT(Port), ~(LEDMask));
+			#define LEDS_PORT_CHANGE(Port, LEDMask, ActiveMask) \
+			                                              Board_ChangePins(Port, ((LEDMask) & LEDS_ON_PORT(Port)), ~(ActiveMask));
+			#define LEDS_PORT_TOGGLE(Port, LEDMask)       Board_TogglePins(Port, ((LEDMask) & LEDS_ON_PORT(Port)));
+			#define LEDS_PORT_GET(Port, Unused)           (LEDS_ON_PORT(Port) ? (~BOARD_PORTREG(Port) & LEDS_ON_PORT(Port)) : 0) |
 	#endif
-	
+
 	/* Public Interface - May be used in end-application: */
 		/* Macros: */
 			/** LED mask for the first LED on the board. */
-			#define LEDS_LED1	(1<<0)	// Yellow
+			#define LEDS_LED1        PIN_LED1_MASK	// Yellow
 
 			/** LED mask for the second LED on the board. */
-			#define LEDS_LED2	(1<<5)	// Green
+			#define LEDS_LED2        PIN_LED2_MASK	// Green
+
+			/** LED mask for the third LED on the board. Not fitted on this board. */
+			#define LEDS_LED3        0
+
+			/** LED mask for the fourth LED on the board. Not fitted on this board. */
+			#define LEDS_LED4        0
 
 			/** LED mask for all the LEDs on the board. */
 			#define LEDS_ALL_LEDS    (LEDS_LED1 | LEDS_LED2)
@@ -82,61 +98,52 @@ LEDS_PORTD_LEDS			#define LEDS_PORTB_LEDS       (LEDS_LED1)
 		#if !defined(__DOXYGEN__)
 			static inline void LEDs_Init(void)
 			{
-				DDRB  |= LEDS_PORTB_LEDS;
-				PORTB |= LEDS_PORTB_LEDS;
-				DDRD  |= LEDS_PORTD_LEDS;
-				PORTD |= LEDS_PORTD_LEDS;
+				BOARD_PORTS(LEDS_PORT_INIT, 0)
 			}
 
 			static inline void LEDs_Disable(void)
 			{
-				DDRB  &= ~LEDS_PORTB_LEDS;
-				PORTB &= ~LEDS_PORTB_LEDS;
-				DDRD  &= ~LEDS_PORTD_LEDS;
-				PORTD &= ~LEDS_PORTD_LEDS;
+				BOARD_PORTS(LEDS_PORT_DISABLE, 0)
 			}
 
 			static inline void LEDs_TurnOnLEDs(const uint8_t LEDMask)
 			{
-				PORTB &= ~(LEDMask & LEDS_PORTB_LEDS);
-				PORTD &= ~(LEDMask & LEDS_PORTD_LEDS);
+				BOARD_PORTS(LEDS_PORT_ON, LEDMask)
 			}
 
 			static inline void LEDs_TurnOffLEDs(const uint8_t LEDMask)
 			{
-				PORTB |= (LEDMask & LEDS_PORTB_LEDS);
-				PORTD |= (LEDMask & LEDS_PORTD_LEDS);
+				BOARD_PORTS(LEDS_PORT_OFF, LEDMask)
 			}
 
 			static inline void LEDs_SetAllLEDs(const uint8_t LEDMask)
 			{
-				PORTB = ((PORTB | LEDS_PORTB_LEDS) & ~(LEDMask & LEDS_PORTB_LEDS));
-				PORTD = ((PORTB | LEDS_PORTD_LEDS) & ~(LEDMask & LEDS_PORTB_LEDS));
+				BOARD_PORTS(LEDS_PORT_SET, LEDMask)
 			}
 
 			static inline void LEDs_ChangeLEDs(const uint8_t LEDMask, const uint8_t ActiveMask)
 			{
-				PORTB = ((PORTB |  (LEDMask & LEDS_PORTB_LEDS)) & ~(ActiveMask & LEDS_PORTB_LEDS));
-				PORTD = ((PORTD |  (LEDMask & LEDS_PORTD_LEDS)) & ~(ActiveMask & LEDS_PORTD_LEDS));
+				BOARD_PORTS(LEDS_PORT_CHANGE, LEDMask, ActiveMask)
 			}
 
 			static inline void LEDs_ToggleLEDs(const uint8_t LEDMask)
 			{
-				PINB  = (LEDMask & LEDS_PORTB_LEDS);
-				PIND  = (LEDMask & LEDS_PORTD_LEDS);
+				BOARD_PORTS(LEDS_PORT_TOGGLE, LEDMask)
 			}
 
 			static inline uint8_t LEDs_GetLEDs(void) ATTR_WARN_UNUSED_RESULT;
 			static inline uint8_t LEDs_GetLEDs(void)
 			{
-				return ((~PORTB & LEDS_PORTB_LEDS) | (~PORTD & LEDS_PORTD_LEDS));
+				return (BOARD_PORTS(LEDS_PORT_GET, 0) 0);
 			}
 		#endif
 
+	/* Compile Time Checks: */
+		_Static_assert(BOARD_GROUP_BITS_UNIQUE(BOARD_LEDS), "the LED masks are the pin masks, so the LEDs need distinct bits");
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
 		#endif
 
 #endif
-
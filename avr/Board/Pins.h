@@ -0,0 +1,218 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2016.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2016  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Board pin map for the WebRadio board.
+ *
+ *  Every GPIO signal of the board is listed once in \ref BOARD_PINS, together with its port and bit. The board
+ *  drivers (LEDs, Buttons, Dataflash) and the application drivers take their pins from this table, so a re-spun PCB
+ *  only needs this file to be changed.
+ *
+ *  All pin numbers and masks derived from the table are compile time constants. The port accessors below therefore
+ *  compile down to a single \c sbi or \c cbi for a single pin, or one port write per port for a group of pins, and
+ *  ports which carry no pin of a mask are not accessed at all. Pins which are assigned twice, and pin combinations
+ *  the drivers cannot handle, are rejected at compile time.
+ */
+
+#ifndef __PINS_USER_H__
+#define __PINS_USER_H__
+
+	/* Includes: */
+		#include <avr/io.h>
+
+		#include <LUFA/Common/Common.h>
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** GPIO ports of the ATmega32U4, numbered in register address order. */
+			#define BOARD_PORT_B                       0
+			#define BOARD_PORT_C                       1
+			#define BOARD_PORT_D                       2
+			#define BOARD_PORT_E                       3
+			#define BOARD_PORT_F                       4
+
+			/** Board pin table, one PIN(Name, Port, Bit) entry per signal. Each entry defines the constants
+			 *  PIN_<Name>_PORT (a BOARD_PORT_* value), PIN_<Name>_BIT and PIN_<Name>_MASK.
+			 */
+			#define BOARD_PINS(PIN)                                                             \
+				PIN(LED1,      B, 0) /* Yellow LED, active low, on /SS so keep it an output */  \
+				PIN(SPI_SCK,   B, 1) /* SPI bus to the PT6524 and the Dataflash */              \
+				PIN(SPI_MOSI,  B, 2)                                                            \
+				PIN(SPI_MISO,  B, 3)                                                            \
+				PIN(LCD_CE,    B, 4) /* PT6524 chip enable, active high */                      \
+				PIN(ENC_A,     B, 5) /* Rotary encoder, on pin change interrupts */             \
+				PIN(ENC_B,     B, 6)                                                            \
+				PIN(FLASH_CS,  B, 7) /* Dataflash chip select, active low */                    \
+				PIN(KEY_COL1,  D, 0) /* Key matrix columns, pulled up */                        \
+				PIN(KEY_COL2,  D, 1)                                                            \
+				PIN(KEY_COL3,  D, 2)                                                            \
+				PIN(KEY_COL4,  D, 3)                                                            \
+				PIN(LED2,      D, 5) /* Green LED, active low */                                \
+				PIN(KEY_ROW1,  F, 4) /* Key matrix rows, driven low one at a time, JTAG off */  \
+				PIN(KEY_ROW2,  F, 5)
+
+			/** Board LEDs, as X(Name, Arg) entries. */
+			#define BOARD_LEDS(X, Arg)         X(LED1, Arg) X(LED2, Arg)
+
+			/** Key matrix rows, row 1 first. */
+			#define BOARD_KEY_ROWS(X, Arg)     X(KEY_ROW1, Arg) X(KEY_ROW2, Arg)
+
+			/** Key matrix columns, column 1 first. */
+			#define BOARD_KEY_COLUMNS(X, Arg)  X(KEY_COL1, Arg) X(KEY_COL2, Arg) X(KEY_COL3, Arg) X(KEY_COL4, Arg)
+
+			/** Rotary encoder lines. */
+			#define BOARD_ENCODER(X, Arg)      X(ENC_A, Arg) X(ENC_B, Arg)
+
+			/** All GPIO ports of the ATmega32U4, as X(Port, ...) entries. */
+			#define BOARD_PORTS(X, ...)        X(BOARD_PORT_B, __VA_ARGS__) X(BOARD_PORT_C, __VA_ARGS__) \
+			                                   X(BOARD_PORT_D, __VA_ARGS__) X(BOARD_PORT_E, __VA_ARGS__) \
+			                                   X(BOARD_PORT_F, __VA_ARGS__)
+
+			/** Mask of the pins of a group which are on the given port, zero if there are none. */
+			#define BOARD_GROUP_MASK(Group, Port)      (Group(BOARD_PIN_MASK_ON_PORT, Port) 0)
+
+			/** Number of pins in a group. */
+			#define BOARD_GROUP_SIZE(Group)            (Group(BOARD_PIN_COUNT, 0) 0)
+
+			/** Non-zero if all pins of a group are on the given port. */
+			#define BOARD_GROUP_ON_PORT(Group, Port)   (Group(BOARD_PIN_IS_ON_PORT, Port) 1)
+
+			/** Non-zero if no two pins of a group share a bit number, so that the pin masks of the group can be
+			 *  combined into a single mask even if the pins are on different ports.
+			 */
+			#define BOARD_GROUP_BITS_UNIQUE(Group)     ((Group(BOARD_PIN_MASK_SUM, 0) 0) == (Group(BOARD_PIN_MASK_OR, 0) 0))
+
+			/** Input, data direction and output registers of a port, by BOARD_PORT_* value. */
+			#define BOARD_PINREG(Port)                 _SFR_IO8(0x03 + (3 * (Port)))
+			#define BOARD_DDRREG(Port)                 _SFR_IO8(0x04 + (3 * (Port)))
+			#define BOARD_PORTREG(Port)                _SFR_IO8(0x05 + (3 * (Port)))
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define BOARD_PIN_CONSTANTS(Name, Port, Bit)   PIN_##Name##_PORT = BOARD_PORT_##Port, \
+			                                               PIN_##Name##_BIT  = (Bit),             \
+			                                               PIN_##Name##_MASK = (1 << (Bit)),
+			#define BOARD_PIN_BIT_VALID(Name, Port, Bit)   ((Bit) < 8) &&
+			#define BOARD_PIN_ID(Name, Port, Bit)          (1ULL << ((BOARD_PORT_##Port * 8) + ((Bit) & 7)))
+			#define BOARD_PIN_ID_SUM(Name, Port, Bit)      BOARD_PIN_ID(Name, Port, Bit) +
+			#define BOARD_PIN_ID_OR(Name, Port, Bit)       BOARD_PIN_ID(Name, Port, Bit) |
+
+			#define BOARD_PIN_MASK_ON_PORT(Name, Port)     ((PIN_##Name##_PORT == (Port)) ? PIN_##Name##_MASK : 0) |
+			#define BOARD_PIN_IS_ON_PORT(Name, Port)       (PIN_##Name##_PORT == (Port)) &&
+			#define BOARD_PIN_COUNT(Name, Arg)             1 +
+			#define BOARD_PIN_MASK_SUM(Name, Arg)          PIN_##Name##_MASK +
+			#define BOARD_PIN_MASK_OR(Name, Arg)           PIN_##Name##_MASK |
+	#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Enums: */
+			/** Port, bit number and mask of every signal in \ref BOARD_PINS. */
+			enum
+			{
+				BOARD_PINS(BOARD_PIN_CONSTANTS)
+			};
+
+		/* Inline Functions: */
+		#if !defined(__DOXYGEN__)
+			static inline void Board_SetPins(const uint8_t Port, const uint8_t Mask) ATTR_ALWAYS_INLINE;
+			static inline void Board_SetPins(const uint8_t Port, const uint8_t Mask)
+			{
+				if (Mask)
+				  BOARD_PORTREG(Port) |= Mask;
+			}
+
+			static inline void Board_ClearPins(const uint8_t Port, const uint8_t Mask) ATTR_ALWAYS_INLINE;
+			static inline void Board_ClearPins(const uint8_t Port, const uint8_t Mask)
+			{
+				if (Mask)
+				  BOARD_PORTREG(Port) &= ~Mask;
+			}
+
+			static inline void Board_ChangePins(const uint8_t Port, const uint8_t Group, const uint8_t Mask) ATTR_ALWAYS_INLINE;
+			static inline void Board_ChangePins(const uint8_t Port, const uint8_t Group, const uint8_t Mask)
+			{
+				if (Group)
+				  BOARD_PORTREG(Port) = ((BOARD_PORTREG(Port) & ~Group) | (Mask & Group));
+			}
+
+			static inline void Board_TogglePins(const uint8_t Port, const uint8_t Mask) ATTR_ALWAYS_INLINE;
+			static inline void Board_TogglePins(const uint8_t Port, const uint8_t Mask)
+			{
+				if (Mask)
+				  BOARD_PINREG(Port) = Mask;
+			}
+
+			static inline uint8_t Board_ReadPins(const uint8_t Port, const uint8_t Mask) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline uint8_t Board_ReadPins(const uint8_t Port, const uint8_t Mask)
+			{
+				return (Mask ? (BOARD_PINREG(Port) & Mask) : 0);
+			}
+
+			static inline void Board_SetOutputs(const uint8_t Port, const uint8_t Mask) ATTR_ALWAYS_INLINE;
+			static inline void Board_SetOutputs(const uint8_t Port, const uint8_t Mask)
+			{
+				if (Mask)
+				  BOARD_DDRREG(Port) |= Mask;
+			}
+
+			static inline void Board_SetInputs(const uint8_t Port, const uint8_t Mask) ATTR_ALWAYS_INLINE;
+			static inline void Board_SetInputs(const uint8_t Port, const uint8_t Mask)
+			{
+				if (Mask)
+				  BOARD_DDRREG(Port) &= ~Mask;
+			}
+
+			static inline void Board_ChangeOutputs(const uint8_t Port, const uint8_t Group, const uint8_t Mask) ATTR_ALWAYS_INLINE;
+			static inline void Board_ChangeOutputs(const uint8_t Port, const uint8_t Group, const uint8_t Mask)
+			{
+				if (Group)
+				  BOARD_DDRREG(Port) = ((BOARD_DDRREG(Port) & ~Group) | (Mask & Group));
+			}
+		#endif
+
+	/* Compile Time Checks: */
+		_Static_assert(BOARD_PINS(BOARD_PIN_BIT_VALID) 1, "a board pin has a bit number beyond 7");
+		_Static_assert((BOARD_PINS(BOARD_PIN_ID_SUM) 0) == (BOARD_PINS(BOARD_PIN_ID_OR) 0),
+		               "two board signals are assigned to the same pin");
+		_Static_assert(BOARD_GROUP_ON_PORT(BOARD_ENCODER, BOARD_PORT_B),
+		               "the encoder needs pin change interrupts, which are only on PORTB");
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
@@ -43,6 +43,32 @@
 #ifndef _APP_CONFIG_H_
 #define _APP_CONFIG_H_
 
-	#define GENERIC_REPORT_SIZE       32
+	#if defined(REPORT_PROFILE_FULLSPEED)
+		/* Full-speed profile: a whole report fits in one 64 byte packet, polled every frame */
+		#define GENERIC_REPORT_SIZE       64
+		#define GENERIC_EPSIZE            64
+		#define GENERIC_POLLING_MS        1
+	#else
+		/* Legacy profile: a report is split over four 8 byte packets, polled every 5 frames */
+		#define GENERIC_REPORT_SIZE       32
+		#define GENERIC_EPSIZE            8
+		#define GENERIC_POLLING_MS        5
+	#endif
+
+	/* Size of the feature report, which carries one settings page at a time */
+	#define GENERIC_FEATURE_SIZE          48
+
+	/* Scheduler task periods in milliseconds, and worst case execution time budgets in CPU cycles */
+	#define KEYS_TASK_BUDGET              500
+	#define DISPLAY_TASK_PERIOD_MS        1
+	#define DISPLAY_TASK_BUDGET           2000
+	#define MARQUEE_TICK_MS               10
+	#define MARQUEE_TASK_BUDGET           8000
+	#define GESTURE_TICK_MS               5
+	#define GESTURE_TASK_BUDGET           1000
+	#define PRESET_TASK_PERIOD_MS         1
+	#define PRESET_TASK_BUDGET            24000
+	#define SETTINGS_TASK_PERIOD_MS       1
+	#define SETTINGS_TASK_BUDGET          1000
 
 #endif
@@ -45,7 +45,47 @@
  */
 const USB_Descriptor_HIDReport_Datatype_t PROGMEM GenericReport[] =
 {
-	HID_DESCRIPTOR_VENDOR(0, 1, 2, 3, 32)
+	/* Vendor defined input and output reports as in HID_DESCRIPTOR_VENDOR(), plus a feature report for settings */
+	HID_RI_USAGE_PAGE(16, 0xFF00),
+	HID_RI_USAGE(8, 0x01),
+	HID_RI_COLLECTION(8, 0x01),
+		HID_RI_USAGE(8, 0x02),
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(8, 0xFF),
+		HID_RI_REPORT_SIZE(8, 0x08),
+		HID_RI_REPORT_COUNT(8, GENERIC_REPORT_SIZE),
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+		HID_RI_USAGE(8, 0x03),
+		HID_RI_REPORT_COUNT(8, GENERIC_REPORT_SIZE),
+		HID_RI_OUTPUT(16, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE | HID_IOF_NON_VOLATILE),
+		HID_RI_USAGE(8, 0x04),
+		HID_RI_REPORT_COUNT(8, GENERIC_FEATURE_SIZE),
+		HID_RI_FEATURE(16, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE | HID_IOF_NON_VOLATILE),
+	HID_RI_END_COLLECTION(0)
+};
+
+/** HID class report descriptor of the Consumer Control interface. The one byte report holds one bit per media key,
+ *  in the order of the CONSUMER_* report bits, so the host's input layer can handle them without a driver.
+ */
+const USB_Descriptor_HIDReport_Datatype_t PROGMEM ConsumerReport[] =
+{
+	HID_RI_USAGE_PAGE(8, 0x0C), /* Consumer */
+	HID_RI_USAGE(8, 0x01), /* Consumer Control */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(8, 0x01),
+		HID_RI_REPORT_SIZE(8, 0x01),
+		HID_RI_REPORT_COUNT(8, 0x06),
+		HID_RI_USAGE(8, 0xE9), /* Volume Increment */
+		HID_RI_USAGE(8, 0xEA), /* Volume Decrement */
+		HID_RI_USAGE(8, 0xE2), /* Mute */
+		HID_RI_USAGE(8, 0xCD), /* Play/Pause */
+		HID_RI_USAGE(8, 0xB5), /* Scan Next Track */
+		HID_RI_USAGE(8, 0xB6), /* Scan Previous Track */
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+		HID_RI_REPORT_COUNT(8, 0x02),
+		HID_RI_INPUT(8, HID_IOF_CONSTANT),
+	HID_RI_END_COLLECTION(0)
 };
 
 /** Device descriptor structure. This descriptor, located in FLASH memory, describes the overall
@@ -87,7 +127,11 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 			.Header                 = {.Size = sizeof(USB_Descriptor_Configuration_Header_t), .Type = DTYPE_Configuration},
 
 			.TotalConfigurationSize = sizeof(USB_Descriptor_Configuration_t),
-			.TotalInterfaces        = 1,
+		#if defined(DISPLAY_STREAM)
+			.TotalInterfaces        = 3,
+		#else
+			.TotalInterfaces        = 2,
+		#endif
 
 			.ConfigurationNumber    = 1,
 			.ConfigurationStrIndex  = NO_DESCRIPTOR,
@@ -131,7 +175,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 			.EndpointAddress        = GENERIC_IN_EPADDR,
 			.Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
 			.EndpointSize           = GENERIC_EPSIZE,
-			.PollingIntervalMS      = 0x05
+			.PollingIntervalMS      = GENERIC_POLLING_MS
 		},
 
 	.HID_ReportOUTEndpoint =
@@ -141,8 +185,73 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 			.EndpointAddress        = GENERIC_OUT_EPADDR,
 			.Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
 			.EndpointSize           = GENERIC_EPSIZE,
+			.PollingIntervalMS      = GENERIC_POLLING_MS
+		},
+
+	.HID_ConsumerInterface =
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Interface_t), .Type = DTYPE_Interface},
+
+			.InterfaceNumber        = INTERFACE_ID_Consumer,
+			.AlternateSetting       = 0x00,
+
+			.TotalEndpoints         = 1,
+
+			.Class                  = HID_CSCP_HIDClass,
+			.SubClass               = HID_CSCP_NonBootSubclass,
+			.Protocol               = HID_CSCP_NonBootProtocol,
+
+			.InterfaceStrIndex      = NO_DESCRIPTOR
+		},
+
+	.HID_ConsumerHID =
+		{
+			.Header                 = {.Size = sizeof(USB_HID_Descriptor_HID_t), .Type = HID_DTYPE_HID},
+
+			.HIDSpec                = VERSION_BCD(1,1,1),
+			.CountryCode            = 0x00,
+			.TotalReportDescriptors = 1,
+			.HIDReportType          = HID_DTYPE_Report,
+			.HIDReportLength        = sizeof(ConsumerReport)
+		},
+
+	.HID_ConsumerINEndpoint =
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Endpoint_t), .Type = DTYPE_Endpoint},
+
+			.EndpointAddress        = CONSUMER_IN_EPADDR,
+			.Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
+			.EndpointSize           = CONSUMER_EPSIZE,
+			.PollingIntervalMS      = CONSUMER_POLLING_MS
+		},
+
+#if defined(DISPLAY_STREAM)
+	.Stream_Interface =
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Interface_t), .Type = DTYPE_Interface},
+
+			.InterfaceNumber        = INTERFACE_ID_Stream,
+			.AlternateSetting       = 0x00,
+
+			.TotalEndpoints         = 1,
+
+			.Class                  = USB_CSCP_VendorSpecificClass,
+			.SubClass               = 0x00,
+			.Protocol               = 0x00,
+
+			.InterfaceStrIndex      = NO_DESCRIPTOR
+		},
+
+	.Stream_DataOUTEndpoint =
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Endpoint_t), .Type = DTYPE_Endpoint},
+
+			.EndpointAddress        = STREAM_OUT_EPADDR,
+			.Attributes             = (EP_TYPE_BULK | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
+			.EndpointSize           = STREAM_EPSIZE,
 			.PollingIntervalMS      = 0x05
 		}
+#endif
 };
 
 /** Language descriptor structure. This descriptor, located in FLASH memory, is returned when the host requests
@@ -208,12 +317,28 @@ uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
 
 			break;
 		case HID_DTYPE_HID:
-			Address = &ConfigurationDescriptor.HID_GenericHID;
-			Size    = sizeof(USB_HID_Descriptor_HID_t);
+			if (wIndex == INTERFACE_ID_Consumer)
+			{
+				Address = &ConfigurationDescriptor.HID_ConsumerHID;
+				Size    = sizeof(USB_HID_Descriptor_HID_t);
+			}
+			else
+			{
+				Address = &ConfigurationDescriptor.HID_GenericHID;
+				Size    = sizeof(USB_HID_Descriptor_HID_t);
+			}
 			break;
 		case HID_DTYPE_Report:
-			Address = &GenericReport;
-			Size    = sizeof(GenericReport);
+			if (wIndex == INTERFACE_ID_Consumer)
+			{
+				Address = &ConsumerReport;
+				Size    = sizeof(ConsumerReport);
+			}
+			else
+			{
+				Address = &GenericReport;
+				Size    = sizeof(GenericReport);
+			}
 			break;
 	}
 
@@ -57,6 +57,17 @@
 			USB_HID_Descriptor_HID_t              HID_GenericHID;
 			USB_Descriptor_Endpoint_t             HID_ReportINEndpoint;
 			USB_Descriptor_Endpoint_t             HID_ReportOUTEndpoint;
+
+			// Consumer Control HID Interface
+			USB_Descriptor_Interface_t            HID_ConsumerInterface;
+			USB_HID_Descriptor_HID_t              HID_ConsumerHID;
+			USB_Descriptor_Endpoint_t             HID_ConsumerINEndpoint;
+
+		#if defined(DISPLAY_STREAM)
+			// Display Stream Vendor Interface
+			USB_Descriptor_Interface_t            Stream_Interface;
+			USB_Descriptor_Endpoint_t             Stream_DataOUTEndpoint;
+		#endif
 		} USB_Descriptor_Configuration_t;
 
 		/** Enum for the device interface descriptor IDs within the device. Each interface descriptor
@@ -66,6 +77,10 @@
 		enum InterfaceDescriptors_t
 		{
 			INTERFACE_ID_GenericHID = 0, /**< GenericHID interface descriptor ID */
+			INTERFACE_ID_Consumer   = 1, /**< Consumer Control HID interface descriptor ID */
+		#if defined(DISPLAY_STREAM)
+			INTERFACE_ID_Stream     = 2, /**< Display stream vendor interface descriptor ID */
+		#endif
 		};
 
 		/** Enum for the device string descriptor IDs within the device. Each string descriptor should
@@ -86,8 +101,49 @@
 		/** Endpoint address of the Generic HID reporting OUT endpoint. */
 		#define GENERIC_OUT_EPADDR        (ENDPOINT_DIR_OUT | 2)
 
-		/** Size in bytes of the Generic HID reporting endpoint. */
-		#define GENERIC_EPSIZE            8
+		/** Endpoint address of the Consumer Control HID reporting IN endpoint. */
+		#define CONSUMER_IN_EPADDR        (ENDPOINT_DIR_IN  | 3)
+
+		/** Size in bytes of the Consumer Control HID reporting endpoint. */
+		#define CONSUMER_EPSIZE           8
+
+		/** Polling interval in milliseconds of the Consumer Control HID reporting endpoint, so that media keys reach the
+		 *  host in the next frame.
+		 */
+		#define CONSUMER_POLLING_MS       1
+
+		/** Endpoint address of the display stream bulk OUT endpoint. */
+		#define STREAM_OUT_EPADDR         (ENDPOINT_DIR_OUT | 4)
+
+		/** Size in bytes of the display stream bulk OUT endpoint, the largest bulk packet at full speed. */
+		#define STREAM_EPSIZE             64
+
+		/** Consumer Control report bit for the Volume Increment usage. */
+		#define CONSUMER_VOLUME_UP        (1 << 0)
+
+		/** Consumer Control report bit for the Volume Decrement usage. */
+		#define CONSUMER_VOLUME_DOWN      (1 << 1)
+
+		/** Consumer Control report bit for the Mute usage. */
+		#define CONSUMER_MUTE             (1 << 2)
+
+		/** Consumer Control report bit for the Play/Pause usage. */
+		#define CONSUMER_PLAY_PAUSE       (1 << 3)
+
+		/** Consumer Control report bit for the Scan Next Track usage. */
+		#define CONSUMER_NEXT             (1 << 4)
+
+		/** Consumer Control report bit for the Scan Previous Track usage. */
+		#define CONSUMER_PREVIOUS         (1 << 5)
+
+	/* Preprocessor Checks: */
+		#if !defined(GENERIC_EPSIZE) || !defined(GENERIC_POLLING_MS)
+			#error The report profile in AppConfig.h must set the Generic HID endpoint size and polling interval.
+		#endif
+
+		#if defined(REPORT_PROFILE_FULLSPEED) && (GENERIC_REPORT_SIZE > GENERIC_EPSIZE)
+			#error The full-speed report profile requires each report to fit into a single endpoint packet.
+		#endif
 
 	/* Function Prototypes: */
 		uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
@@ -0,0 +1,317 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "display.h"
+#include "pt6524.h"
+
+#include <stdint.h>
+
+#include <avr/pgmspace.h>
+
+// Segments of a 16-segment cell, 14- and 7-segment cells use a subset:
+//
+//     -A1- -A2-
+//    |\   |   /|
+//    F H  I  J B
+//    |  \ | /  |
+//     -G1- -G2-
+//    |  / | \  |
+//    E K  L  M C
+//    |/   |   \|
+//     -D1- -D2-
+//
+#define S_A1	_BV(0)
+#define S_A2	_BV(1)
+#define S_B		_BV(2)
+#define S_C		_BV(3)
+#define S_D1	_BV(4)
+#define S_D2	_BV(5)
+#define S_E		_BV(6)
+#define S_F		_BV(7)
+#define S_G1	_BV(8)
+#define S_G2	_BV(9)
+#define S_H		_BV(10)
+#define S_I		_BV(11)
+#define S_J		_BV(12)
+#define S_K		_BV(13)
+#define S_L		_BV(14)
+#define S_M		_BV(15)
+
+#define S_A		(S_A1 | S_A2)
+#define S_D		(S_D1 | S_D2)
+#define S_G		(S_G1 | S_G2)
+
+// ' ' to '_', lower case and Latin-1 letters are folded onto these
+static const uint16_t PROGMEM font[] = {
+	0,												// ' '
+	S_I,											// '!'
+	S_F | S_I,										// '"'
+	S_B | S_C | S_D | S_G | S_I | S_L,				// '#'
+	S_A | S_F | S_G | S_C | S_D | S_I | S_L,		// '$'
+	S_A1 | S_F | S_G | S_C | S_D2 | S_I | S_L | S_J | S_K,	// '%'
+	S_A1 | S_H | S_I | S_G1 | S_E | S_D | S_M,		// '&'
+	S_I,											// apostrophe
+	S_J | S_M,										// '('
+	S_H | S_K,										// ')'
+	S_G | S_H | S_I | S_J | S_K | S_L | S_M,		// '*'
+	S_G | S_I | S_L,								// '+'
+	S_K,											// ','
+	S_G,											// '-'
+	S_D1,											// '.'
+	S_J | S_K,										// '/'
+	S_A | S_B | S_C | S_D | S_E | S_F | S_J | S_K,	// '0'
+	S_B | S_C | S_J,								// '1'
+	S_A | S_B | S_G | S_E | S_D,					// '2'
+	S_A | S_B | S_G2 | S_C | S_D,					// '3'
+	S_F | S_G | S_B | S_C,							// '4'
+	S_A | S_F | S_G | S_C | S_D,					// '5'
+	S_A | S_F | S_G | S_E | S_C | S_D,				// '6'
+	S_A | S_B | S_C,								// '7'
+	S_A | S_B | S_C | S_D | S_E | S_F | S_G,		// '8'
+	S_A | S_B | S_C | S_D | S_F | S_G,				// '9'
+	S_I | S_L,										// ':'
+	S_I | S_K,										// ';'
+	S_J | S_M,										// '<'
+	S_G | S_D,										// '='
+	S_H | S_K,										// '>'
+	S_A | S_B | S_G2 | S_L,							// '?'
+	S_A | S_B | S_G2 | S_I | S_D | S_E | S_F,		// '@'
+	S_A | S_B | S_C | S_E | S_F | S_G,				// 'A'
+	S_A | S_B | S_C | S_D | S_G2 | S_I | S_L,		// 'B'
+	S_A | S_D | S_E | S_F,							// 'C'
+	S_A | S_B | S_C | S_D | S_I | S_L,				// 'D'
+	S_A | S_D | S_E | S_F | S_G1,					// 'E'
+	S_A | S_E | S_F | S_G1,							// 'F'
+	S_A | S_C | S_D | S_E | S_F | S_G2,				// 'G'
+	S_B | S_C | S_E | S_F | S_G,					// 'H'
+	S_A | S_D | S_I | S_L,							// 'I'
+	S_B | S_C | S_D | S_E,							// 'J'
+	S_E | S_F | S_G1 | S_J | S_M,					// 'K'
+	S_D | S_E | S_F,								// 'L'
+	S_B | S_C | S_E | S_F | S_H | S_J,				// 'M'
+	S_B | S_C | S_E | S_F | S_H | S_M,				// 'N'
+	S_A | S_B | S_C | S_D | S_E | S_F,				// 'O'
+	S_A | S_B | S_E | S_F | S_G,					// 'P'
+	S_A | S_B | S_C | S_D | S_E | S_F | S_M,		// 'Q'
+	S_A | S_B | S_E | S_F | S_G | S_M,				// 'R'
+	S_A | S_C | S_D | S_F | S_G,					// 'S'
+	S_A | S_I | S_L,								// 'T'
+	S_B | S_C | S_D | S_E | S_F,					// 'U'
+	S_E | S_F | S_K | S_J,							// 'V'
+	S_B | S_C | S_E | S_F | S_K | S_M,				// 'W'
+	S_H | S_J | S_K | S_M,							// 'X'
+	S_H | S_J | S_L,								// 'Y'
+	S_A | S_D | S_J | S_K,							// 'Z'
+	S_A2 | S_I | S_L | S_D2,						// '['
+	S_H | S_M,										// backslash
+	S_A1 | S_I | S_L | S_D1,						// ']'
+	S_K | S_M,										// '^'
+	S_D,											// '_'
+};
+
+// Latin-1 0xC0..0xFF onto the letters above
+static const uint8_t PROGMEM latin1[] = {
+	'A', 'A', 'A', 'A', 'A', 'A', 'A', 'C', 'E', 'E', 'E', 'E', 'I', 'I', 'I', 'I',
+	'D', 'N', 'O', 'O', 'O', 'O', 'O', 'X', 'O', 'U', 'U', 'U', 'U', 'Y', 'P', 'S',
+	'A', 'A', 'A', 'A', 'A', 'A', 'A', 'C', 'E', 'E', 'E', 'E', 'I', 'I', 'I', 'I',
+	'D', 'N', 'O', 'O', 'O', 'O', 'O', '/', 'O', 'U', 'U', 'U', 'U', 'Y', 'P', 'Y',
+};
+
+#define CELL_16SEG		0
+#define CELL_14SEG		1
+#define CELL_7SEG		2
+
+// segment -> bit within the outputs of a cell, four commons per output
+static const uint16_t PROGMEM cell_map[][16] = {
+	[CELL_16SEG] = {
+		_BV(0), _BV(1), _BV(2), _BV(3), _BV(4), _BV(5), _BV(6), _BV(7),
+		_BV(8), _BV(9), _BV(10), _BV(11), _BV(12), _BV(13), _BV(14), _BV(15),
+	},
+	[CELL_14SEG] = {
+		_BV(0), _BV(0), _BV(1), _BV(2), _BV(3), _BV(3), _BV(4), _BV(5),
+		_BV(6), _BV(7), _BV(8), _BV(9), _BV(10), _BV(11), _BV(12), _BV(13),
+	},
+	[CELL_7SEG] = {
+		_BV(0), _BV(0), _BV(1), _BV(2), _BV(3), _BV(3), _BV(4), _BV(5),
+		_BV(6), _BV(6), 0, 0, 0, 0, 0, 0,
+	},
+};
+
+// segment outputs (SGn) used by one cell
+static const uint8_t PROGMEM cell_outputs[] = {
+	[CELL_16SEG] = 4,
+	[CELL_14SEG] = 4,
+	[CELL_7SEG] = 2,
+};
+
+typedef struct _panel_field {
+	uint8_t type;
+	uint8_t first;		// first segment output, 0 = SG1
+	uint8_t cells;
+} panel_field_t;
+
+// The panel layout, this is the only place which knows how the glass is wired.
+// SG51 is left for the icons.
+static const panel_field_t PROGMEM panel[DISPLAY_FIELDS] = {
+	[DISPLAY_FIELD_TEXT] = { CELL_16SEG, 0, 9 },		// SG1..SG36
+	[DISPLAY_FIELD_PRESET] = { CELL_14SEG, 36, 2 },		// SG37..SG44
+	[DISPLAY_FIELD_NUMBER] = { CELL_7SEG, 44, 3 },		// SG45..SG50
+};
+
+// maps any Latin-1 character onto the font
+static uint8_t display_fold(uint8_t c) {
+	if(c >= 0xC0)
+		return pgm_read_byte(&latin1[c - 0xC0]);
+	if(c >= 'a' && c <= 'z')
+		return c - ('a' - 'A');
+
+	switch(c) {
+	case '`':
+		return '\'';
+	case '{':
+		return '(';
+	case '|':
+		return ':';
+	case '}':
+		return ')';
+	case '~':
+		return '-';
+	case 0xA0:
+		return ' ';
+	}
+
+	if(c < ' ')
+		return ' ';
+	if(c > '_')
+		return '?';
+	return c;
+}
+
+uint8_t display_field_width(uint8_t field) {
+	if(field >= DISPLAY_FIELDS)
+		return 0;
+	return pgm_read_byte(&panel[field].cells);
+}
+
+uint8_t display_field_outputs(uint8_t field, uint8_t *first) {
+	if(field >= DISPLAY_FIELDS)
+		return 0;
+
+	*first = pgm_read_byte(&panel[field].first);
+	return pgm_read_byte(&panel[field].cells) * pgm_read_byte(&cell_outputs[pgm_read_byte(&panel[field].type)]);
+}
+
+void display_putc(uint8_t field, uint8_t pos, uint8_t c) {
+	const uint16_t *map;
+	uint16_t glyph;
+	uint16_t bits = 0;
+	uint8_t type;
+	uint8_t output;
+	uint8_t outputs;
+	uint8_t i;
+
+	if(pos >= display_field_width(field))
+		return;
+
+	type = pgm_read_byte(&panel[field].type);
+	outputs = pgm_read_byte(&cell_outputs[type]);
+	output = pgm_read_byte(&panel[field].first) + pos * outputs;
+	map = cell_map[type];
+	glyph = pgm_read_word(&font[display_fold(c) - ' ']);
+
+	for(i=0;i<16;i++) {
+		if(glyph & 1)
+			bits |= pgm_read_word(&map[i]);
+		glyph >>= 1;
+	}
+
+	for(i=0;i<outputs;i++) {
+		pt6524_set_digit(output + i, bits & 0x0F);
+		bits >>= 4;
+	}
+}
+
+void display_puts(uint8_t field, const char *str) {
+	display_writer_t writer;
+
+	display_text_begin(&writer, field, false);
+	while(display_text_feed(&writer, *str++))
+		;
+	display_text_end(&writer);
+}
+
+void display_text_begin(display_writer_t *writer, uint8_t field, bool utf8) {
+	writer->field = (field < DISPLAY_FIELDS) ? field : DISPLAY_FIELD_NONE;
+	writer->pos = 0;
+	writer->more = 0;
+	writer->utf8 = utf8;
+}
+
+uint8_t display_text_decode(display_writer_t *writer, uint8_t data) {
+	if(!writer->utf8 || data < 0x80)
+		return data;
+
+	if(data >= 0xC0) {
+		writer->lead = data;
+		writer->more = (data >= 0xF0) ? 3 : (data >= 0xE0) ? 2 : 1;
+		return 0;
+	}
+	if(!writer->more || --writer->more)
+		return 0;
+
+	// only U+0080..U+00FF have a Latin-1 equivalent
+	if(writer->lead == 0xC2 || writer->lead == 0xC3)
+		return ((writer->lead & 0x03) << 6) | (data & 0x3F);
+	return '?';
+}
+
+bool display_text_feed(display_writer_t *writer, uint8_t data) {
+	uint8_t c;
+
+	if(writer->field == DISPLAY_FIELD_NONE)
+		return false;
+
+	// the string ends early, blank the rest of the field
+	if(!data) {
+		display_text_end(writer);
+		return false;
+	}
+
+	c = display_text_decode(writer, data);
+	if(!c)
+		return true;
+
+	display_putc(writer->field, writer->pos++, c);
+	return writer->pos < display_field_width(writer->field);
+}
+
+void display_text_end(display_writer_t *writer) {
+	uint8_t width = display_field_width(writer->field);
+
+	while(writer->pos < width) {
+		display_putc(writer->field, writer->pos++, ' ');
+	}
+	writer->field = DISPLAY_FIELD_NONE;
+}
@@ -0,0 +1,62 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// text fields of the front panel, see the panel table in display.c
+#define DISPLAY_FIELD_TEXT		0	// main line, 16-segment cells
+#define DISPLAY_FIELD_PRESET	1	// preset number, 14-segment cells
+#define DISPLAY_FIELD_NUMBER	2	// frequency/bitrate/clock, 7-segment cells
+#define DISPLAY_FIELDS			3
+#define DISPLAY_FIELD_NONE		0xFF
+
+// incremental text writer, so strings can be rendered while they arrive
+typedef struct _display_writer {
+	uint8_t field;
+	uint8_t pos;
+	uint8_t lead;		// pending UTF-8 lead byte
+	uint8_t more;		// continuation bytes still expected after it
+	bool utf8;
+} display_writer_t;
+
+uint8_t display_field_width(uint8_t field);
+// PT6524 segment outputs of a field, returns their number and sets the first one
+uint8_t display_field_outputs(uint8_t field, uint8_t *first);
+
+// renders a single Latin-1 character into the back buffer of the PT6524
+void display_putc(uint8_t field, uint8_t pos, uint8_t c);
+void display_puts(uint8_t field, const char *str);
+
+void display_text_begin(display_writer_t *writer, uint8_t field, bool utf8);
+// returns the Latin-1 character, 0 while a UTF-8 sequence is incomplete
+uint8_t display_text_decode(display_writer_t *writer, uint8_t data);
+bool display_text_feed(display_writer_t *writer, uint8_t data);
+void display_text_end(display_writer_t *writer);
+
+#endif
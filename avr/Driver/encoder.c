@@ -0,0 +1,145 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "encoder.h"
+#include "scheduler.h"
+#include "latency.h"
+
+#include <stdint.h>
+
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+#define ENC_MASK		(_BV(PIN_ENCA) | _BV(PIN_ENCB))
+
+// previous AB state in bits 2..3, current in bits 0..1 -> quarter step, transitions
+// with no or both lines changed are bounce or missed edges and count nothing
+static const int8_t PROGMEM enc_table[16] = {
+	 0, -1,  1,  0,
+	 1,  0,  0, -1,
+	-1,  0,  0,  1,
+	 0,  1, -1,  0
+};
+
+// detent interval in ms below which a step counts several times
+typedef struct _enc_accel {
+	uint8_t interval;
+	uint8_t steps;
+} enc_accel_t;
+
+static const enc_accel_t PROGMEM enc_accel[] = {
+	{ 15, 8 },
+	{ 30, 4 },
+	{ 60, 2 },
+};
+
+static event_queue_t *queue;
+
+static uint8_t state;			// last AB state
+static int8_t quarters;			// quarter steps since the last detent
+static uint16_t last_detent;	// sched_now() of the last detent
+static volatile int16_t sum;
+
+static uint8_t encoder_read(void) {
+	uint8_t pins = PIN_ENC;
+
+	return ((pins & _BV(PIN_ENCA)) ? 2 : 0) | ((pins & _BV(PIN_ENCB)) ? 1 : 0);
+}
+
+void encoder_init(event_queue_t *events) {
+	queue = events;
+
+	DDR_ENC &= ~ENC_MASK;	// inputs with pull-up
+	PORT_ENC |= ENC_MASK;
+	state = encoder_read();
+
+	PCMSK0 |= ENC_MASK;
+	PCICR |= _BV(PCIE0);
+}
+
+int8_t encoder_take(void) {
+	int16_t steps;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		steps = sum;
+		if(steps > 127)
+			steps = 127;
+		else if(steps < -127)
+			steps = -127;
+		sum -= steps;
+	}
+	return steps;
+}
+
+void encoder_clear(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		sum = 0;
+	}
+}
+
+bool encoder_pending(void) {
+	bool pending;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		pending = sum;
+	}
+	return pending;
+}
+
+ISR(PCINT0_vect) {
+	uint8_t current = encoder_read();
+	uint16_t now;
+	uint8_t interval;
+	int8_t steps = 1;
+	uint8_t i;
+
+	quarters += pgm_read_byte(&enc_table[(state << 2) | current]);
+	state = current;
+
+	if(quarters > -ENC_STEPS_PER_DETENT && quarters < ENC_STEPS_PER_DETENT)
+		return;
+
+	// a full detent, the faster the knob turns the further it goes
+	latency_mark();
+	now = sched_now();
+	interval = (now - last_detent > 0xFF) ? 0xFF : now - last_detent;
+	last_detent = now;
+
+	for(i=0;i<sizeof(enc_accel)/sizeof(enc_accel[0]);i++) {
+		if(interval < pgm_read_byte(&enc_accel[i].interval)) {
+			steps = pgm_read_byte(&enc_accel[i].steps);
+			break;
+		}
+	}
+	if(quarters < 0)
+		steps = -steps;
+	quarters = 0;
+
+	// saturates, the sum must not overflow to get there (int is 16 bits)
+	if(steps > 0 ? sum <= INT16_MAX - steps : sum >= INT16_MIN - steps)
+		sum += steps;
+	event_put(queue, EVENT_ENCODER, steps);
+}
@@ -0,0 +1,60 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <avr/io.h>
+
+#include "../Board/Pins.h"
+#include "event.h"
+
+// A and B lines of the rotary encoder, from the board pin map (pin change interrupt
+// capable pins of PORTB), may be overridden by the board configuration
+#ifndef PORT_ENC
+	#define DDR_ENC			BOARD_DDRREG(PIN_ENC_A_PORT)
+	#define PORT_ENC		BOARD_PORTREG(PIN_ENC_A_PORT)
+	#define PIN_ENC			BOARD_PINREG(PIN_ENC_A_PORT)
+	#define PIN_ENCA		PIN_ENC_A_BIT
+	#define PIN_ENCB		PIN_ENC_B_BIT
+#endif
+
+#define ENC_STEPS_PER_DETENT	4	// quadrature states between two detents
+
+// Decodes the encoder from the pin change interrupt. Each detent is queued as an
+// EVENT_ENCODER event with its accelerated step count (int8_t), and added to a
+// running sum which the USB side collects once per report.
+void encoder_init(event_queue_t *events);
+
+// returns the steps since the last call, at most +-127, and clears them
+int8_t encoder_take(void);
+// drops the steps not taken yet
+void encoder_clear(void);
+bool encoder_pending(void);
+
+#endif
@@ -0,0 +1,79 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "event.h"
+#include "scheduler.h"
+
+#include <stdint.h>
+
+_Static_assert(!(EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)), "the queue size is a power of two");
+_Static_assert(EVENT_QUEUE_SIZE <= 128, "the indices are 8 bit");
+
+#define EVENT_MASK			(EVENT_QUEUE_SIZE - 1)
+
+// keeps the compiler from moving the record access across the index update
+#define event_barrier()		__asm__ __volatile__ ("" ::: "memory")
+
+bool event_put(event_queue_t *queue, uint8_t type, uint8_t data) {
+	uint8_t head = queue->head;
+	event_t *event;
+
+	// the indices run freely, the difference is the fill level
+	if((uint8_t)(head - queue->tail) == EVENT_QUEUE_SIZE) {
+		queue->dropped++;
+		return false;
+	}
+
+	event = &queue->events[head & EVENT_MASK];
+	event->type = type;
+	event->data = data;
+	event->time = sched_now();
+
+	event_barrier();
+	queue->head = head + 1;
+	return true;
+}
+
+bool event_get(event_queue_t *queue, event_t *event) {
+	uint8_t tail = queue->tail;
+
+	if(tail == queue->head)
+		return false;
+
+	event_barrier();
+	*event = queue->events[tail & EVENT_MASK];
+
+	event_barrier();
+	queue->tail = tail + 1;
+	return true;
+}
+
+bool event_pending(const event_queue_t *queue) {
+	return queue->head != queue->tail;
+}
+
+uint8_t event_count(const event_queue_t *queue) {
+	return queue->head - queue->tail;
+}
@@ -0,0 +1,65 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define EVENT_QUEUE_SIZE	16		// must be a power of two
+
+// event types
+#define EVENT_NONE			0
+#define EVENT_DISPLAY_DONE	1		// the PT6524 transfer has completed
+#define EVENT_KEY_DOWN		2		// data is the key number
+#define EVENT_KEY_UP		3
+#define EVENT_ENCODER		4		// data is the accelerated step count, int8_t
+#define EVENT_COMMAND		5		// data is the slot holding the command report
+
+typedef struct _event {
+	uint8_t type;
+	uint8_t data;
+	uint16_t time;		// sched_now() when the event was queued
+} event_t;
+
+// Ring buffer with exactly one producer and one consumer, e.g. an ISR and the main
+// loop. Each side only writes its own index, so no interrupts have to be disabled.
+typedef struct _event_queue {
+	volatile uint8_t head;		// written by the producer
+	volatile uint8_t tail;		// written by the consumer
+	uint8_t dropped;			// events lost because the queue was full
+	event_t events[EVENT_QUEUE_SIZE];
+} event_queue_t;
+
+// producer side, false if the queue is full
+bool event_put(event_queue_t *queue, uint8_t type, uint8_t data);
+// consumer side, false if the queue is empty
+bool event_get(event_queue_t *queue, event_t *event);
+bool event_pending(const event_queue_t *queue);
+// number of events waiting, either side
+uint8_t event_count(const event_queue_t *queue);
+
+#endif
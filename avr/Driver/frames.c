@@ -0,0 +1,142 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "frames.h"
+#include "display.h"
+#include "pt6524.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <util/atomic.h>
+
+typedef struct _frame {
+	uint8_t handle;
+	uint8_t field;				// DISPLAY_FIELD_NONE for an unused entry
+	uint8_t data[FRAMES_OUTPUTS / 2];	// two outputs per byte, the lower one in the low nibble
+} frame_t;
+
+static frame_t frames[FRAMES_COUNT];
+
+// entry indices, most recently used first
+static uint8_t lru[FRAMES_COUNT];
+
+static frames_stats_t stats;
+
+void frames_flush(void) {
+	uint8_t i;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		for(i=0;i<FRAMES_COUNT;i++) {
+			frames[i].field = DISPLAY_FIELD_NONE;
+			lru[i] = i;
+		}
+	}
+}
+
+// position in the LRU list of the frame with the handle, FRAMES_COUNT if there is none
+static uint8_t frames_find(uint8_t handle) {
+	uint8_t i;
+
+	for(i=0;i<FRAMES_COUNT;i++) {
+		if(frames[lru[i]].field != DISPLAY_FIELD_NONE && frames[lru[i]].handle == handle)
+			break;
+	}
+	return i;
+}
+
+// moves an entry to the front of the LRU list and returns it
+static frame_t *frames_touch(uint8_t pos) {
+	uint8_t entry = lru[pos];
+
+	memmove(&lru[1], &lru[0], pos);
+	lru[0] = entry;
+	return &frames[entry];
+}
+
+bool frames_store(uint8_t handle, uint8_t field) {
+	frame_t *frame;
+	uint8_t first;
+	uint8_t outputs = display_field_outputs(field, &first);
+	uint8_t pos;
+	uint8_t i;
+
+	if(!outputs || outputs > FRAMES_OUTPUTS)
+		return false;
+
+	// reuse the entry of the handle, or take the least recently used one
+	pos = frames_find(handle);
+	if(pos == FRAMES_COUNT) {
+		pos = FRAMES_COUNT - 1;
+		if(frames[lru[pos]].field != DISPLAY_FIELD_NONE)
+			stats.evictions++;
+	}
+
+	frame = frames_touch(pos);
+	frame->handle = handle;
+	frame->field = field;
+
+	// cells always have an even number of outputs
+	for(i=0;i<outputs;i+=2) {
+		frame->data[i / 2] = pt6524_get_digit(first + i) | (pt6524_get_digit(first + i + 1) << 4);
+	}
+	return true;
+}
+
+uint8_t frames_show(uint8_t handle) {
+	frame_t *frame;
+	uint8_t first;
+	uint8_t outputs;
+	uint8_t pos = frames_find(handle);
+	uint8_t i;
+
+	if(pos == FRAMES_COUNT) {
+		stats.misses++;
+		return DISPLAY_FIELD_NONE;
+	}
+
+	stats.hits++;
+	frame = frames_touch(pos);
+	outputs = display_field_outputs(frame->field, &first);
+
+	for(i=0;i<outputs;i+=2) {
+		pt6524_set_digit(first + i, frame->data[i / 2] & 0x0F);
+		pt6524_set_digit(first + i + 1, frame->data[i / 2] >> 4);
+	}
+	return frame->field;
+}
+
+void frames_get_stats(frames_stats_t *current) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		*current = stats;
+	}
+}
+
+void frames_reset_stats(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memset(&stats, 0, sizeof(stats));
+	}
+}
@@ -0,0 +1,56 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef FRAMES_H
+#define FRAMES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Cache of rendered display fields, keyed by a handle chosen by the host. A field is
+// stored as the commons of its PT6524 segment outputs, so showing it again needs neither
+// the text nor the font. The least recently used frame makes room for a new one.
+#define FRAMES_COUNT		8
+#define FRAMES_OUTPUTS		36		// the widest field, see the panel table in display.c
+
+typedef struct _frames_stats {
+	uint16_t hits;
+	uint16_t misses;
+	uint16_t evictions;
+} frames_stats_t;
+
+// stores the current content of a display field under the handle, replacing a frame
+// with the same handle
+bool frames_store(uint8_t handle, uint8_t field);
+// draws a stored frame back into its field and returns the field, DISPLAY_FIELD_NONE if
+// the frame is not cached
+uint8_t frames_show(uint8_t handle);
+// forgets all frames, e.g. when the host starts over with its handles
+void frames_flush(void);
+
+void frames_get_stats(frames_stats_t *stats);
+void frames_reset_stats(void);
+
+#endif
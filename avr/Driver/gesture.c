@@ -0,0 +1,164 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "gesture.h"
+#include "scheduler.h"
+
+#include <stdint.h>
+
+#include <util/atomic.h>
+
+#define GESTURE_KEYS	8
+
+// key states
+#define KEY_IDLE		0
+#define KEY_DOWN		1	// first press
+#define KEY_RELEASED	2	// waiting for a second press
+#define KEY_DOWN2		3	// second press
+#define KEY_HELD		4	// long press sent, auto-repeating
+
+typedef struct _gesture_key {
+	uint8_t state;
+	uint16_t since;		// time of the last state change or repeat
+	uint16_t interval;	// current auto-repeat interval
+} gesture_key_t;
+
+static event_queue_t *queue;
+static gesture_key_t keys[GESTURE_KEYS];
+
+static gesture_config_t config = {
+	.double_ms = 250,
+	.long_ms = 600,
+	.repeat_ms = 200,
+	.repeat_min_ms = 40,
+	.repeat_accel_ms = 20,
+};
+
+void gesture_init(event_queue_t *gestures) {
+	queue = gestures;
+}
+
+// may be called from the USB interrupt
+void gesture_set_config(const gesture_config_t *new_config) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		config = *new_config;
+	}
+}
+
+void gesture_get_config(gesture_config_t *current) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		*current = config;
+	}
+}
+
+bool gesture_key(const event_t *event) {
+	gesture_config_t current;
+	gesture_key_t *key;
+	bool sent = false;
+
+	if(event->data >= GESTURE_KEYS)
+		return false;
+
+	key = &keys[event->data];
+	gesture_get_config(&current);
+
+	if(event->type == EVENT_KEY_DOWN) {
+		key->state = (key->state == KEY_RELEASED) ? KEY_DOWN2 : KEY_DOWN;
+	} else {
+		switch(key->state) {
+		case KEY_DOWN:
+			if(current.double_ms) {
+				key->state = KEY_RELEASED;
+				break;
+			}
+			sent = event_put(queue, GESTURE_CLICK, event->data);
+			key->state = KEY_IDLE;
+			break;
+		case KEY_DOWN2:
+			sent = event_put(queue, GESTURE_DOUBLE, event->data);
+			key->state = KEY_IDLE;
+			break;
+		default:
+			key->state = KEY_IDLE;
+			break;
+		}
+	}
+
+	// timed from the debounced edge, not from when the event was handled
+	key->since = event->time;
+	return sent;
+}
+
+bool gesture_tick(void) {
+	gesture_config_t current;
+	gesture_key_t *key;
+	uint16_t now = sched_now();
+	uint16_t held;
+	bool sent = false;
+	uint8_t i;
+
+	gesture_get_config(&current);
+
+	for(i=0;i<GESTURE_KEYS;i++) {
+		key = &keys[i];
+		held = now - key->since;
+
+		switch(key->state) {
+		case KEY_DOWN2:
+			// a click followed by a long press
+			if(held < current.long_ms)
+				break;
+			sent |= event_put(queue, GESTURE_CLICK, i);
+			// fall through
+		case KEY_DOWN:
+			if(held < current.long_ms)
+				break;
+			sent |= event_put(queue, GESTURE_LONG, i);
+			key->state = KEY_HELD;
+			key->since += current.long_ms;
+			key->interval = current.repeat_ms;
+			break;
+		case KEY_HELD:
+			if(!key->interval || held < key->interval)
+				break;
+			sent |= event_put(queue, GESTURE_REPEAT, i);
+			key->since += key->interval;
+			// speed up, but never below the minimum interval
+			if(key->interval > current.repeat_min_ms + current.repeat_accel_ms)
+				key->interval -= current.repeat_accel_ms;
+			else
+				key->interval = current.repeat_min_ms ? current.repeat_min_ms : 1;
+			break;
+		case KEY_RELEASED:
+			if(held < current.double_ms)
+				break;
+			sent |= event_put(queue, GESTURE_CLICK, i);
+			key->state = KEY_IDLE;
+			break;
+		}
+	}
+
+	return sent;
+}
@@ -0,0 +1,58 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "event.h"
+
+// gestures, queued as events with the key number as data
+#define GESTURE_CLICK		0x10
+#define GESTURE_DOUBLE		0x11
+#define GESTURE_LONG		0x12	// held for long_ms
+#define GESTURE_REPEAT		0x13	// still held after the long press
+
+// all times in ms
+typedef struct _gesture_config {
+	uint16_t double_ms;			// second press for a double click, 0 sends clicks on release
+	uint16_t long_ms;
+	uint16_t repeat_ms;			// first auto-repeat interval, 0 for no auto-repeat
+	uint16_t repeat_min_ms;
+	uint16_t repeat_accel_ms;	// the interval shrinks by this after each repeat
+} gesture_config_t;
+
+void gesture_init(event_queue_t *gestures);
+void gesture_set_config(const gesture_config_t *config);
+void gesture_get_config(gesture_config_t *config);
+
+// feeds a key event, true if a gesture has been queued
+bool gesture_key(const event_t *event);
+// times the held and released keys, to be called periodically
+bool gesture_tick(void);
+
+#endif
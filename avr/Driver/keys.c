@@ -0,0 +1,99 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "keys.h"
+#include "latency.h"
+#include "scheduler.h"
+
+#include <stdint.h>
+
+#include <LUFA/Drivers/Board/Buttons.h>
+
+_Static_assert(BUTTONS_ROWS * BUTTONS_COLUMNS <= 8, "the keys fit into one byte");
+
+static event_queue_t *queue;
+
+// debounced state and a 2 bit vertical counter per key, ct1:ct0
+static uint8_t state;
+static uint8_t ct0 = 0xFF;
+static uint8_t ct1 = 0xFF;
+
+// sched_timestamp() of the first scan that saw a key differ from its debounced state,
+// kept while any key is being counted
+static uint16_t first_change;
+static bool counting;
+
+void keys_init(event_queue_t *events) {
+	queue = events;
+
+	Buttons_Init();
+}
+
+// counts every key which differs from its debounced state, and resets the counter
+// of all others, so all keys are debounced in parallel with a few instructions
+static uint8_t keys_debounce(uint8_t keys) {
+	uint8_t changed = state ^ keys;
+
+	ct0 = ~(ct0 & changed);
+	ct1 = ct0 ^ (ct1 & changed);
+
+	// the counter has rolled over, the key was stable for four samples
+	changed &= ct0 & ct1;
+	state ^= changed;
+
+	return changed;
+}
+
+void keys_scan(void) {
+	uint8_t keys;
+	uint8_t changed;
+	uint8_t i;
+
+	// both rows on every tick, each after the column lines have settled, so a key
+	// is debounced over four ticks
+	keys = Buttons_GetStatus();
+	if(keys != state && !counting) {
+		first_change = sched_timestamp();
+		counting = true;
+	}
+	changed = keys_debounce(keys);
+
+	// the latency is timed from the first edge, a bounce back restarts it along with
+	// the counter
+	if(changed)
+		latency_mark_at(first_change);
+	if(keys == state)
+		counting = false;
+
+	for(i=0;changed;i++) {
+		if(changed & 1)
+			event_put(queue, (state & _BV(i)) ? EVENT_KEY_DOWN : EVENT_KEY_UP, i);
+		changed >>= 1;
+	}
+}
+
+uint8_t keys_state(void) {
+	return state;
+}
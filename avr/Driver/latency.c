@@ -0,0 +1,104 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "latency.h"
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <util/atomic.h>
+
+static volatile bool marked;
+static uint16_t mark;			// input not yet carried by a report
+static bool in_flight;
+static uint16_t in_flight_mark;	// input carried by the report being sent
+
+static latency_stats_t stats;
+static uint32_t sum;
+
+// may be called from any interrupt
+void latency_mark(void) {
+	latency_mark_at(sched_timestamp());
+}
+
+void latency_mark_at(uint16_t timestamp) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if(!marked) {
+			mark = timestamp;
+			marked = true;
+		}
+	}
+}
+
+void latency_start(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		in_flight = marked;
+		in_flight_mark = mark;
+		marked = false;
+	}
+}
+
+void latency_done(void) {
+	uint16_t latency;
+	uint16_t bins;
+	uint8_t bin = 0;
+
+	if(!in_flight)
+		return;
+	in_flight = false;
+
+	latency = sched_timestamp() - in_flight_mark;
+
+	// the sample count saturates, which keeps the average at its last value
+	if(stats.count == 0xFFFF)
+		return;
+
+	if(!stats.count || latency < stats.min)
+		stats.min = latency;
+	if(latency > stats.max)
+		stats.max = latency;
+	sum += latency;
+	stats.count++;
+	stats.avg = sum / stats.count;
+
+	for(bins=latency;bins>1;bins>>=1)
+		bin++;
+	stats.histogram[bin]++;
+}
+
+void latency_get(latency_stats_t *current) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		*current = stats;
+	}
+}
+
+void latency_reset(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memset(&stats, 0, sizeof(stats));
+		sum = 0;
+	}
+}
@@ -0,0 +1,57 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+#define LATENCY_BINS		16
+
+// Input to report latency in SCHED_TIMESTAMP_NS units. Bin n of the histogram counts
+// latencies from 2^n up to 2^(n+1) - 1, bin 0 also counts zero. Keys are timed from the
+// first scan that saw them change, so the latency includes the debounce.
+typedef struct _latency_stats {
+	uint16_t min;
+	uint16_t avg;
+	uint16_t max;
+	uint16_t count;
+	uint16_t histogram[LATENCY_BINS];
+} latency_stats_t;
+
+// an input edge, only the first one before a report is started is timed
+void latency_mark(void);
+// an input edge seen earlier, at the given sched_timestamp(), for inputs which are only
+// accepted some time after their first edge
+void latency_mark_at(uint16_t timestamp);
+// a report has been started, it carries all inputs marked so far
+void latency_start(void);
+// the last packet of the report has been handed to the USB controller
+void latency_done(void);
+
+void latency_get(latency_stats_t *stats);
+void latency_reset(void);
+
+#endif
@@ -0,0 +1,172 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "ledfx.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#include <LUFA/Drivers/Board/LEDs.h>
+
+// Timer 3 runs at F_CPU/8 in CTC mode, OCR3A ends the PWM period and turns the lit LEDs
+// on, OCR3B and OCR3C turn LED 1 and LED 2 off again.
+#define LEDFX_TOP		8128	// (255 * 255) >> 3, full brightness is never switched off
+#define LEDFX_PERIOD_US	((LEDFX_TOP + 1) * 8UL / (F_CPU / 1000000UL))
+
+#define DUTY_FULL		0xFFFF	// beyond TOP, the compare never matches
+
+_Static_assert(LEDFX_LEDS == 2, "one compare unit per LED");
+
+typedef struct _ledfx_state {
+	ledfx_t fx;
+	uint8_t level;		// brightness in the current period
+	uint8_t start;		// brightness when a fade was started
+	uint16_t phase;		// position in the effect cycle, wraps once per cycle
+	uint16_t step;		// phase advance per PWM period
+} ledfx_state_t;
+
+static ledfx_state_t leds[LEDFX_LEDS];
+
+void ledfx_init(void) {
+	OCR3A = LEDFX_TOP;
+	OCR3B = 0;
+	OCR3C = 0;
+	TCCR3A = 0;
+	TCCR3B = _BV(WGM32) | _BV(CS31);
+	TIMSK3 = _BV(OCIE3A) | _BV(OCIE3B) | _BV(OCIE3C);
+}
+
+// phase advance per PWM period for one effect cycle of the given length
+static uint16_t ledfx_rate(const ledfx_t *fx) {
+	uint32_t cycle = (uint32_t)fx->time * 1000;
+	uint32_t step;
+
+	// a blink pattern has eight steps of time each
+	if(fx->effect == LEDFX_BLINK)
+		cycle *= 8;
+
+	step = (LEDFX_PERIOD_US << 16) / cycle;
+	if(step > 0xFFFF)
+		return 0xFFFF;
+	return step ? step : 1;
+}
+
+void ledfx_set(uint8_t mask, const ledfx_t *fx) {
+	ledfx_state_t *led;
+	uint16_t step = fx->time ? ledfx_rate(fx) : 0;
+	uint8_t i;
+
+	for(i=0;i<LEDFX_LEDS;i++) {
+		if(!(mask & ((i == 0) ? LEDS_LED1 : LEDS_LED2)))
+			continue;
+
+		led = &leds[i];
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			led->fx = *fx;
+			if(!step)
+				led->fx.effect = LEDFX_STEADY;
+			led->start = led->level;
+			led->phase = 0;
+			led->step = step;
+		}
+	}
+}
+
+void ledfx_set_all(uint8_t mask) {
+	ledfx_t on = { LEDFX_STEADY, LEDFX_FULL, 0, 0 };
+	ledfx_t off = { LEDFX_STEADY, 0, 0, 0 };
+
+	ledfx_set(mask, &on);
+	ledfx_set(LEDS_ALL_LEDS & ~mask, &off);
+}
+
+// brightness of an LED for the next PWM period
+static uint8_t ledfx_step(ledfx_state_t *led) {
+	uint16_t phase = led->phase;
+	uint8_t x;
+
+	led->phase += led->step;
+
+	switch(led->fx.effect) {
+	case LEDFX_BLINK:
+		return (led->fx.pattern & (0x80 >> (phase >> 13))) ? led->fx.level : 0;
+	case LEDFX_BREATHE:
+		// triangle, rising in the first half of the cycle
+		x = phase >> 7;
+		if(phase & 0x8000)
+			x = ~x;
+		return (x * led->fx.level) >> 8;
+	case LEDFX_FADE:
+		if(led->phase < phase) {
+			led->fx.effect = LEDFX_STEADY;
+			return led->fx.level;
+		}
+		x = phase >> 8;
+		if(led->fx.level >= led->start)
+			return led->start + (((uint16_t)(led->fx.level - led->start) * x) >> 8);
+		return led->start - (((uint16_t)(led->start - led->fx.level) * x) >> 8);
+	default:
+		return led->fx.level;
+	}
+}
+
+// square law as a cheap gamma curve
+static uint16_t ledfx_duty(uint8_t level) {
+	if(level == LEDFX_FULL)
+		return DUTY_FULL;
+	return ((uint16_t)level * level) >> 3;
+}
+
+static inline void ledfx_period(ledfx_state_t *led, volatile uint16_t *ocr, uint8_t mask) {
+	uint16_t duty;
+
+	led->level = ledfx_step(led);
+	duty = ledfx_duty(led->level);
+	*ocr = duty;
+
+	// the compare may already have passed if this interrupt was held up, the LED stays
+	// off for this period then rather than on
+	if(duty && TCNT3 < duty)
+		LEDs_TurnOnLEDs(mask);
+	else
+		LEDs_TurnOffLEDs(mask);
+}
+
+ISR(TIMER3_COMPA_vect) {
+	ledfx_period(&leds[0], &OCR3B, LEDS_LED1);
+	ledfx_period(&leds[1], &OCR3C, LEDS_LED2);
+}
+
+ISR(TIMER3_COMPB_vect) {
+	LEDs_TurnOffLEDs(LEDS_LED1);
+}
+
+ISR(TIMER3_COMPC_vect) {
+	LEDs_TurnOffLEDs(LEDS_LED2);
+}
@@ -0,0 +1,57 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef LEDFX_H
+#define LEDFX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Brightness and effects for the board LEDs. Neither LED sits on an output compare pin,
+// so Timer 3 switches them from its compare interrupts at ~250Hz and steps the effects
+// once per PWM period, nothing runs in the main loop.
+#define LEDFX_LEDS		2
+#define LEDFX_FULL		255
+
+// effects
+#define LEDFX_STEADY	0	// constant level
+#define LEDFX_BLINK		1	// level while the pattern bit is set, one bit per time ms, MSB first
+#define LEDFX_BREATHE	2	// from off up to level and back down, once per time ms
+#define LEDFX_FADE		3	// from the current brightness to level in time ms, then steady
+
+typedef struct _ledfx {
+	uint8_t effect;
+	uint8_t level;		// perceived brightness, 0 is off
+	uint16_t time;		// ms, 0 sets the level right away
+	uint8_t pattern;
+} ledfx_t;
+
+void ledfx_init(void);
+// starts an effect on the LEDs in the mask (LEDS_LEDn), may be called from any interrupt
+void ledfx_set(uint8_t leds, const ledfx_t *fx);
+// switches the LEDs in the mask fully on and all others off, as LEDs_SetAllLEDs()
+void ledfx_set_all(uint8_t leds);
+
+#endif
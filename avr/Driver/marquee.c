@@ -0,0 +1,139 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "marquee.h"
+#include "display.h"
+
+#include <stdint.h>
+
+static uint8_t text[MARQUEE_LENGTH];
+static uint8_t length;
+static display_writer_t writer;
+
+static bool running;
+static uint8_t field = DISPLAY_FIELD_NONE;
+static uint8_t offset;
+static int8_t direction;
+static uint16_t countdown;
+
+static uint8_t speed = 25;
+static uint8_t pause = 100;
+static uint8_t mode = MARQUEE_WRAP;
+
+static void marquee_render(void) {
+	uint8_t width = display_field_width(field);
+	uint8_t i;
+	uint8_t pos = offset;
+
+	for(i=0;i<width;i++) {
+		display_putc(field, i, (pos < length) ? text[pos] : ' ');
+		if(++pos == length + MARQUEE_GAP)
+			pos = 0;
+	}
+}
+
+bool marquee_begin(uint8_t new_field, bool utf8, bool append) {
+	running = false;
+
+	// the field indexes the panel layout on every tick
+	if(new_field >= DISPLAY_FIELDS) {
+		field = DISPLAY_FIELD_NONE;
+		return false;
+	}
+
+	if(!append || new_field != field) {
+		field = new_field;
+		length = 0;
+	}
+	display_text_begin(&writer, field, utf8);
+	return true;
+}
+
+void marquee_feed(uint8_t data) {
+	uint8_t c;
+
+	if(!data)
+		return;
+
+	c = display_text_decode(&writer, data);
+	if(c && length < MARQUEE_LENGTH)
+		text[length++] = c;
+}
+
+void marquee_end(void) {
+	if(field == DISPLAY_FIELD_NONE)
+		return;
+
+	offset = 0;
+	direction = 1;
+	countdown = speed + pause;
+	marquee_render();
+
+	// a title which fits is shown as is
+	running = length > display_field_width(field);
+}
+
+void marquee_set_speed(uint8_t new_speed, uint8_t new_pause, uint8_t new_mode) {
+	speed = new_speed ? new_speed : 1;
+	pause = new_pause;
+	mode = new_mode;
+}
+
+void marquee_get_speed(uint8_t *current_speed, uint8_t *current_pause, uint8_t *current_mode) {
+	*current_speed = speed;
+	*current_pause = pause;
+	*current_mode = mode;
+}
+
+void marquee_stop(uint8_t stop_field) {
+	if(stop_field == field) {
+		running = false;
+		field = DISPLAY_FIELD_NONE;
+	}
+}
+
+void marquee_tick(void) {
+	uint8_t last;
+
+	if(!running || --countdown)
+		return;
+	countdown = speed;
+
+	if(mode == MARQUEE_BOUNCE) {
+		last = length - display_field_width(field);
+		offset += direction;
+		if(offset == 0 || offset >= last) {
+			direction = -direction;
+			countdown += pause;
+		}
+	} else {
+		if(++offset == length + MARQUEE_GAP)
+			offset = 0;
+		if(offset == 0)
+			countdown += pause;
+	}
+
+	marquee_render();
+}
@@ -0,0 +1,54 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef MARQUEE_H
+#define MARQUEE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MARQUEE_LENGTH		128		// longest title kept on the device
+#define MARQUEE_GAP			3		// blanks between the end and the start in wrap mode
+
+// scroll modes
+#define MARQUEE_WRAP		0		// scrolls left and starts over after a gap
+#define MARQUEE_BOUNCE		1		// scrolls left to the end, then back right
+
+// Starts a new title for a display field. With append set the text is added to the
+// title being uploaded, so it can be longer than a single report. False if there is no
+// such field, the text fed is then dropped.
+bool marquee_begin(uint8_t field, bool utf8, bool append);
+void marquee_feed(uint8_t data);
+// shows the title, it is only scrolled if it is wider than the field
+void marquee_end(void);
+
+// speed is in ticks per step, pause is the number of ticks to hold at the ends
+void marquee_set_speed(uint8_t speed, uint8_t pause, uint8_t mode);
+void marquee_get_speed(uint8_t *speed, uint8_t *pause, uint8_t *mode);
+// stops scrolling if the field is taken over by other text
+void marquee_stop(uint8_t field);
+void marquee_tick(void);
+
+#endif
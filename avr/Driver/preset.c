@@ -0,0 +1,426 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "preset.h"
+#include "pt6524.h"
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <util/atomic.h>
+#include <util/crc16.h>
+
+#include <LUFA/Drivers/Board/Dataflash.h>
+
+// two index pages written in turn, each one a sequence number, the entries and a CRC
+#define INDEX_PAGES			2
+#define INDEX_SEQUENCE		0
+#define INDEX_ENTRIES		2
+#define INDEX_CRC			(INDEX_ENTRIES + PRESET_COUNT * 2)
+#define INDEX_FORMAT		0x01	// CRC seed, bump when the index layout changes
+#define INDEX_NONE			0xFF	// no valid index page, the store is empty
+#define INDEX_EMPTY			0xFFFF
+#define SEQUENCE_ERASED		0xFFFF
+#define SLOT(preset, n)		(INDEX_PAGES + (preset) * 2 + (n))
+
+// density code in the status register, 0111 for the AT45DB041D
+#define FLASH_DENSITY_MASK	0x3C
+#define FLASH_DENSITY		0x1C
+
+// flash detection, done on the first task run once the display has released the bus
+#define FLASH_UNKNOWN		0
+#define FLASH_PRESENT		1
+#define FLASH_MISSING		2
+#define FLASH_SCAN			3	// found, the index pages are read next
+
+// cache states
+#define CACHE_IDLE			0	// holds cache_preset, if any
+#define CACHE_LOADING		1	// being filled from the flash by the task
+#define CACHE_STAGING		2	// being filled by preset_write()
+#define CACHE_PROGRAM		3	// to be written to the free slot of cache_preset
+#define CACHE_INDEX			4	// written, the index is to be pointed at cache_slot
+
+_Static_assert(PRESET_SIZE == DATAFLASH_PAGE_SIZE, "a record is one flash page");
+_Static_assert(INDEX_CRC < DATAFLASH_PAGE_SIZE, "the index fits into one page");
+_Static_assert(SLOT(PRESET_COUNT, 0) <= DATAFLASH_PAGES, "all record slots fit into the flash");
+
+static uint8_t cache[PRESET_SIZE];
+static volatile uint8_t cache_preset = PRESET_NONE;
+static volatile uint8_t cache_state;
+static uint16_t cache_slot;
+
+// preset to load once the cache is free, set by readers
+static volatile uint8_t request = PRESET_NONE;
+
+// time of the last preset_write(), an upload left alone for too long is dropped
+static uint16_t staging_time;
+
+// index page in use, and its sequence number
+static uint8_t index_page = INDEX_NONE;
+static uint16_t index_sequence;
+
+static uint8_t flash;
+static bool flash_writing;
+
+void preset_init(void) {
+	// keep the chip off the bus before the display starts sending
+	Dataflash_Init();
+}
+
+bool preset_present(void) {
+	return flash == FLASH_PRESENT;
+}
+
+bool preset_busy(void) {
+	return cache_state >= CACHE_PROGRAM || flash_writing;
+}
+
+static uint8_t flash_status(void) {
+	uint8_t status;
+
+	Dataflash_SelectChip(DATAFLASH_CHIP1);
+	Dataflash_SendByte(DF_CMD_GETSTATUS);
+	status = Dataflash_ReceiveByte();
+	Dataflash_DeselectChip();
+	return status;
+}
+
+static void flash_read(uint16_t page, uint16_t offset, uint8_t *data, uint16_t length) {
+	Dataflash_SelectChipFromPage(page);
+	Dataflash_SendByte(DF_CMD_CONTARRAYREAD_LF);
+	Dataflash_SendAddressBytes(page, offset);
+	while(length--)
+		*data++ = Dataflash_ReceiveByte();
+	Dataflash_DeselectChip();
+}
+
+// CRC over an index page as it is, or with one entry and the sequence number changed,
+// read straight from the flash. Without a valid index page all entries are empty.
+static uint8_t index_crc(uint8_t page, uint16_t sequence, uint8_t preset, uint16_t entry) {
+	uint8_t crc = INDEX_FORMAT;
+	uint8_t data;
+	uint8_t i;
+
+	crc = _crc8_ccitt_update(crc, sequence & 0xFF);
+	crc = _crc8_ccitt_update(crc, sequence >> 8);
+
+	if(page != INDEX_NONE) {
+		Dataflash_SelectChipFromPage(page);
+		Dataflash_SendByte(DF_CMD_CONTARRAYREAD_LF);
+		Dataflash_SendAddressBytes(page, INDEX_ENTRIES);
+	}
+	for(i=0;i<PRESET_COUNT*2;i++) {
+		data = (page != INDEX_NONE) ? Dataflash_ReceiveByte() : 0xFF;
+		if(i / 2 == preset)
+			data = (i & 1) ? entry >> 8 : entry & 0xFF;
+		crc = _crc8_ccitt_update(crc, data);
+	}
+	Dataflash_DeselectChip();
+	return crc;
+}
+
+// finds the latest intact index page, as settings_load() does for the EEPROM journal
+static void index_scan(void) {
+	uint16_t sequence;
+	uint8_t crc;
+	uint8_t page;
+
+	index_page = INDEX_NONE;
+	for(page=0;page<INDEX_PAGES;page++) {
+		flash_read(page, INDEX_SEQUENCE, (uint8_t *)&sequence, sizeof(sequence));
+		flash_read(page, INDEX_CRC, &crc, sizeof(crc));
+		if(sequence == SEQUENCE_ERASED || crc != index_crc(page, sequence, PRESET_NONE, 0))
+			continue;
+
+		// the two pages are always one step apart, even when the sequence wraps
+		if(index_page != INDEX_NONE && (int16_t)(sequence - index_sequence) <= 0)
+			continue;
+
+		index_page = page;
+		index_sequence = sequence;
+	}
+}
+
+// record page of a preset, INDEX_EMPTY for erased or foreign entries
+static uint16_t index_get(uint8_t preset) {
+	uint16_t page;
+
+	if(index_page == INDEX_NONE)
+		return INDEX_EMPTY;
+
+	flash_read(index_page, INDEX_ENTRIES + preset * 2, (uint8_t *)&page, sizeof(page));
+	if(page != SLOT(preset, 0) && page != SLOT(preset, 1))
+		return INDEX_EMPTY;
+	return page;
+}
+
+// Writes the index with one entry changed to the other index page, through buffer 2.
+// The page in use is left as it is, so a power loss during the write keeps the old
+// index, and the new one is only taken once its CRC is intact.
+static void index_set(uint8_t preset, uint16_t page) {
+	uint8_t next = (index_page == 0) ? 1 : 0;
+	uint16_t sequence = index_sequence + 1;
+	uint8_t crc;
+	uint8_t i;
+
+	if(sequence == SEQUENCE_ERASED)
+		sequence = 0;
+	crc = index_crc(index_page, sequence, preset, page);
+
+	if(index_page != INDEX_NONE) {
+		Dataflash_SelectChipFromPage(index_page);
+		Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF2);
+		Dataflash_SendAddressBytes(index_page, 0);
+		Dataflash_DeselectChip();
+
+		// the page transfer takes at most a few hundred us
+		Dataflash_SelectChipFromPage(index_page);
+		Dataflash_WaitWhileBusy();
+		Dataflash_DeselectChip();
+	} else {
+		Dataflash_SelectChipFromPage(next);
+		Dataflash_SendByte(DF_CMD_BUFF2WRITE);
+		Dataflash_SendAddressBytes(0, INDEX_ENTRIES);
+		for(i=0;i<PRESET_COUNT*2;i++)
+			Dataflash_SendByte(0xFF);
+		Dataflash_DeselectChip();
+	}
+
+	Dataflash_SelectChipFromPage(next);
+	Dataflash_SendByte(DF_CMD_BUFF2WRITE);
+	Dataflash_SendAddressBytes(0, INDEX_SEQUENCE);
+	Dataflash_SendByte(sequence & 0xFF);
+	Dataflash_SendByte(sequence >> 8);
+
+	Dataflash_ToggleSelectedChipCS();
+	Dataflash_SendByte(DF_CMD_BUFF2WRITE);
+	Dataflash_SendAddressBytes(0, INDEX_ENTRIES + preset * 2);
+	Dataflash_SendByte(page & 0xFF);
+	Dataflash_SendByte(page >> 8);
+
+	Dataflash_ToggleSelectedChipCS();
+	Dataflash_SendByte(DF_CMD_BUFF2WRITE);
+	Dataflash_SendAddressBytes(0, INDEX_CRC);
+	Dataflash_SendByte(crc);
+
+	Dataflash_ToggleSelectedChipCS();
+	Dataflash_SendByte(DF_CMD_BUFF2TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(next, 0);
+	Dataflash_DeselectChip();
+
+	index_page = next;
+	index_sequence = sequence;
+}
+
+// writes the cache through buffer 1 into a record page
+static void record_write(uint16_t page) {
+	uint16_t i;
+
+	Dataflash_SelectChipFromPage(page);
+	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, 0);
+	for(i=0;i<PRESET_SIZE;i++)
+		Dataflash_SendByte(cache[i]);
+
+	Dataflash_ToggleSelectedChipCS();
+	Dataflash_SendByte(DF_CMD_BUFF1TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(page, 0);
+	Dataflash_DeselectChip();
+}
+
+static void cache_load(uint8_t preset) {
+	uint16_t page = index_get(preset);
+
+	if(page == INDEX_EMPTY)
+		memset(cache, 0xFF, sizeof(cache));
+	else
+		flash_read(page, 0, cache, sizeof(cache));
+}
+
+void preset_abort(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if(cache_state == CACHE_STAGING) {
+			cache_preset = PRESET_NONE;
+			cache_state = CACHE_IDLE;
+		}
+	}
+}
+
+void preset_task(void) {
+	uint8_t preset = PRESET_NONE;
+	uint16_t now = sched_now();
+
+	if(flash == FLASH_MISSING)
+		return;
+
+	// an upload the host has given up on would hold the cache for good
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if(cache_state == CACHE_STAGING && (uint16_t)(now - staging_time) >= PRESET_UPLOAD_TIMEOUT_MS) {
+			cache_preset = PRESET_NONE;
+			cache_state = CACHE_IDLE;
+		}
+	}
+
+	// nothing to do, leave the bus to the display
+	if(flash == FLASH_PRESENT && !flash_writing && cache_state < CACHE_PROGRAM &&
+	   (request == PRESET_NONE || cache_state != CACHE_IDLE))
+		return;
+
+	if(!pt6524_bus_acquire())
+		return;
+
+	if(flash == FLASH_UNKNOWN) {
+		flash = ((flash_status() & FLASH_DENSITY_MASK) == FLASH_DENSITY) ? FLASH_SCAN : FLASH_MISSING;
+		pt6524_bus_release();
+		return;
+	}
+
+	if(flash == FLASH_SCAN) {
+		index_scan();
+		flash = FLASH_PRESENT;
+		pt6524_bus_release();
+		return;
+	}
+
+	// the chip is still programming the last page, its buffers and array are off limits
+	if(flash_writing) {
+		if(!(flash_status() & DF_STATUS_READY)) {
+			pt6524_bus_release();
+			return;
+		}
+		flash_writing = false;
+	}
+
+	switch(cache_state) {
+	case CACHE_IDLE:
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			if(cache_state == CACHE_IDLE && request != PRESET_NONE) {
+				preset = request;
+				request = PRESET_NONE;
+				if(preset != cache_preset)
+					cache_state = CACHE_LOADING;
+			}
+		}
+		if(cache_state != CACHE_LOADING)
+			break;
+
+		cache_load(preset);
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			cache_preset = preset;
+			cache_state = CACHE_IDLE;
+		}
+		break;
+	case CACHE_PROGRAM:
+		// write the slot the index does not point to
+		cache_slot = SLOT(cache_preset, 0);
+		if(index_get(cache_preset) == cache_slot)
+			cache_slot = SLOT(cache_preset, 1);
+
+		record_write(cache_slot);
+		flash_writing = true;
+		cache_state = CACHE_INDEX;
+		break;
+	case CACHE_INDEX:
+		index_set(cache_preset, cache_slot);
+		flash_writing = true;
+		cache_state = CACHE_IDLE;
+		break;
+	}
+
+	pt6524_bus_release();
+}
+
+bool preset_read(uint8_t preset, uint16_t offset, void *data, uint16_t length) {
+	if(flash != FLASH_PRESENT || preset >= PRESET_COUNT || offset >= PRESET_SIZE)
+		return false;
+	if(length > PRESET_SIZE - offset)
+		length = PRESET_SIZE - offset;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		// a record being written is already complete in the cache
+		if(preset == cache_preset && cache_state != CACHE_LOADING && cache_state != CACHE_STAGING) {
+			memcpy(data, &cache[offset], length);
+			return true;
+		}
+		request = preset;
+	}
+	return false;
+}
+
+// takes the cache over for an upload, keeping a record which is already being uploaded,
+// and dropping the upload of another one
+static bool cache_claim(uint8_t preset) {
+	if(flash != FLASH_PRESENT || preset >= PRESET_COUNT)
+		return false;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		staging_time = sched_now();
+
+		if(cache_state == CACHE_STAGING && cache_preset == preset)
+			return true;
+		if(cache_state != CACHE_IDLE && cache_state != CACHE_STAGING)
+			return false;
+
+		memset(cache, 0xFF, sizeof(cache));
+		cache_preset = preset;
+		cache_state = CACHE_STAGING;
+	}
+	return true;
+}
+
+bool preset_write(uint8_t preset, uint16_t offset, const void *data, uint8_t length) {
+	if(offset >= PRESET_SIZE || length > PRESET_SIZE - offset)
+		return false;
+	if(!cache_claim(preset))
+		return false;
+
+	memcpy(&cache[offset], data, length);
+	return true;
+}
+
+bool preset_commit(uint8_t preset) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if(cache_state != CACHE_STAGING || cache_preset != preset)
+			return false;
+
+		cache_state = CACHE_PROGRAM;
+	}
+	return true;
+}
+
+bool preset_erase(uint8_t preset) {
+	if(!cache_claim(preset))
+		return false;
+
+	// the cache reads as the empty record straight away
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memset(cache, 0xFF, sizeof(cache));
+		cache_slot = INDEX_EMPTY;
+		cache_state = CACHE_INDEX;
+	}
+	return true;
+}
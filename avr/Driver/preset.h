@@ -0,0 +1,75 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef PRESET_H
+#define PRESET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Station presets on the Dataflash. Pages 0 and 1 hold the index, one little endian
+// page number per preset, and are written in turn with a sequence number and a CRC,
+// as the settings journal is. Each preset has two record pages which are written in
+// turn as well, so the index only moves to a new record once it has been written
+// completely, and only the latest intact index is used. An erased chip is an empty
+// store.
+#define PRESET_COUNT		64
+#define PRESET_NONE			0xFF
+#define PRESET_SIZE			264		// one Dataflash page per record
+
+// an upload with no preset_write() for this long is dropped
+#define PRESET_UPLOAD_TIMEOUT_MS	2000
+
+// record layout, everything after the name belongs to the host, e.g. the stream URL
+#define PRESET_FLAGS		0
+#define PRESET_NAME_LENGTH	1		// 0xFF in an empty record
+#define PRESET_NAME			2
+#define PRESET_NAME_SIZE	32
+
+// record flags
+#define PRESET_UTF8			(1 << 0)
+
+void preset_init(void);
+// false if no Dataflash has been found
+bool preset_present(void);
+// runs the flash transfers for the page cache, to be called periodically from the main loop
+void preset_task(void);
+// true while a record is being written
+bool preset_busy(void);
+
+// Copies part of a record from the one page RAM cache, so it may be called from the USB
+// interrupt. Returns false if the record is not cached, its load is queued then.
+bool preset_read(uint8_t preset, uint16_t offset, void *data, uint16_t length);
+
+// Upload, the record is built up in the page cache and written by preset_commit(). Parts
+// not written read back as 0xFF. Starting the upload of another preset drops the one in
+// progress. All return false while a record is being written.
+bool preset_write(uint8_t preset, uint16_t offset, const void *data, uint8_t length);
+bool preset_commit(uint8_t preset);
+bool preset_erase(uint8_t preset);
+// drops an upload which has not been committed, e.g. when the host goes away
+void preset_abort(void);
+
+#endif
@@ -23,56 +23,296 @@
 //  Created by Laszlo Hegedues on 21.03.2017.
 //
 
-#include "config.h"
+#include "pt6524.h"
 
-#include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 
 #include <avr/io.h>
-#include "utils/io.h"
-#include "utils/spi.h"
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include <LUFA/Drivers/Peripheral/SPI.h>
 
 #define PT_ADDRESS		0x82	// 41H in the "stupid" datasheet configuration
+#define PT_FRAME_SIZE	8		// one serial transfer, see "SERIAL DATA INPUT" in the datasheet
 
-typedef struct _segment {
-	uint8_t nibble:4;
-} pt6524_seg_t;
-
-typedef struct _frame __attribute__((packed)) {
-	pt6524_seg_t segments[13];
-	uint8_t _res:2;
-	uint8_t cu:1;
-	uint8_t port:3;
-	uint8_t dr:1;
-	uint8_t sc:1;
-	uint8_t bu:1;
-	uint8_t dd:2;
+// Layout of a transfer as clocked out MSB first, D1 (of the block) being the first bit:
+//
+//   byte 0..5   D1..D48, one nibble per segment output (COM1 in the high bit)
+//   byte 6      D49..D52 | CU P0 P1 P2
+//   byte 7      P3 DR SC BU 0 0 DD
+//
+// The control bits are only sent in the first block and are zero in all others,
+// DD numbers the block (0..3).
+#define PT_DISPLAY_BYTES	6
+#define PT_CTRL_BYTE		6
+#define PT_CTRL_BYTE2		7
+
+#define PT_CU			0x08	// in PT_CTRL_BYTE
+#define PT_P0			0x04
+#define PT_P1			0x02
+#define PT_P2			0x01
+#define PT_P3			0x80	// in PT_CTRL_BYTE2
+#define PT_DR			0x40
+#define PT_SC			0x20
+#define PT_BU			0x10
+#define PT_DD			0x03
+
+typedef struct _frame {
+	uint8_t data[PT_FRAME_SIZE];
 } pt6524_frame_t;
 
-uint8_t pt6524_init() {
-	pt6524_frame_t frame;
-	
-	// init the SPI
-	spi_init();
+_Static_assert(sizeof(pt6524_frame_t) == PT_FRAME_SIZE, "a transfer is exactly 64 bits");
+_Static_assert(PT_DIGITS_PER_BLOCK * 4 == PT_DISPLAY_BYTES * 8 + 4, "a transfer carries 52 display bits");
+_Static_assert(PT_BLOCKS * PT_DIGITS_PER_BLOCK >= PT_DIGITS, "all segment outputs fit into the transfers");
+_Static_assert(PT_BLOCKS - 1 <= PT_DD, "every block has its own DD code");
+
+// bit position within a byte -> mask, the AVR has no barrel shifter
+static const uint8_t PROGMEM pt_bit_mask[8] = {
+	0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01
+};
+
+// COM1..COM4 in bits 0..3 -> wire order, COM1 is sent first
+static const uint8_t PROGMEM pt_nibble[16] = {
+	0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+	0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+};
+
+// the frame currently shown by the chip, and the one being drawn
+static pt6524_frame_t front[PT_BLOCKS];
+static pt6524_frame_t back[PT_BLOCKS];
+
+// blocks of the back buffer touched since the last commit
+static volatile uint8_t dirty;
+
+// transmit queue, blocks of the front buffer still to be sent by the SPI interrupt
+static volatile uint8_t tx_queue;
+static const uint8_t *tx_data;
+static uint8_t tx_count;
+static volatile bool tx_busy;
+static pt6524_callback_t tx_done;
+
+// the SPI bus has been handed to another device, commits wait until it is returned
+static volatile bool bus_lent;
+
+static void pt6524_send_next(void);
+
+void pt6524_init(void) {
+	uint8_t i;
+
+	// init the SPI, the chip takes at most ~3MHz, transfers are driven by the SPI interrupt
+	SPI_Init(SPI_SPEED_FCPU_DIV_8 | SPI_ORDER_MSB_FIRST | SPI_SCK_LEAD_RISING | SPI_SAMPLE_LEADING | SPI_MODE_MASTER);
+	SPCR |= _BV(SPIE);
 	DDR_PT |= _BV(DDR_PTS);		// and the CS-Line
-	
-	memset(frame, 0, sizeof(pt6524_frame_t));
-	frame.dr = 1;
-	
-	pt6524_write(&buffer);
+	PORT_PT &= ~_BV(PORT_PTS);
+
+	memset(back, 0, sizeof(back));
+	for(i=0;i<PT_BLOCKS;i++) {
+		back[i].data[PT_CTRL_BYTE2] = i & PT_DD;
+	}
+	back[0].data[PT_CTRL_BYTE2] |= PT_DR;	// 1/2 bias
+
+	// force the complete frame out, the chip powers up with undefined data
+	memset(front, 0xFF, sizeof(front));
+	dirty = (1 << PT_BLOCKS) - 1;
+	pt6524_commit();
+}
+
+void pt6524_clear(void) {
+	uint8_t i;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		for(i=0;i<PT_BLOCKS;i++) {
+			memset(back[i].data, 0, PT_DISPLAY_BYTES);
+			back[i].data[PT_CTRL_BYTE] &= 0x0F;
+		}
+		dirty = (1 << PT_BLOCKS) - 1;
+	}
+}
+
+void pt6524_set_segment(uint8_t segment, bool on) {
+	uint8_t block = segment / PT_SEGMENTS_PER_BLOCK;
+	uint8_t bit = segment % PT_SEGMENTS_PER_BLOCK;
+	uint8_t *data;
+	uint8_t mask;
+
+	if(segment >= PT_SEGMENTS)
+		return;
+
+	data = &back[block].data[bit / 8];
+	mask = pgm_read_byte(&pt_bit_mask[bit % 8]);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if(on)
+			*data |= mask;
+		else
+			*data &= ~mask;
+		dirty |= _BV(block);
+	}
+}
+
+void pt6524_set_digit(uint8_t digit, uint8_t coms) {
+	uint8_t block = digit / PT_DIGITS_PER_BLOCK;
+	uint8_t nibble = digit % PT_DIGITS_PER_BLOCK;
+	uint8_t *data;
+	uint8_t bits;
+
+	if(digit >= PT_DIGITS)
+		return;
+
+	data = &back[block].data[nibble / 2];
+	bits = pgm_read_byte(&pt_nibble[coms & 0x0F]);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		// even outputs go to the high nibble, they are sent first
+		if(nibble & 1)
+			*data = (*data & 0xF0) | bits;
+		else
+			*data = (*data & 0x0F) | (bits << 4);
+		dirty |= _BV(block);
+	}
+}
+
+uint8_t pt6524_get_digit(uint8_t digit) {
+	uint8_t block = digit / PT_DIGITS_PER_BLOCK;
+	uint8_t nibble = digit % PT_DIGITS_PER_BLOCK;
+	uint8_t bits;
+
+	if(digit >= PT_DIGITS)
+		return 0;
+
+	bits = back[block].data[nibble / 2];
+	bits = (nibble & 1) ? (bits & 0x0F) : (bits >> 4);
+
+	// the wire order is reversed, so the table maps it back as well
+	return pgm_read_byte(&pt_nibble[bits]);
 }
 
-void pt6524_write(uint8_t *buf) {
+void pt6524_set_display(bool on) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if(on)
+			back[0].data[PT_CTRL_BYTE2] &= ~PT_SC;
+		else
+			back[0].data[PT_CTRL_BYTE2] |= PT_SC;
+		dirty |= _BV(0);
+	}
+}
+
+bool pt6524_commit(void) {
+	uint8_t pending;
 	uint8_t i;
-	
-	// send the address
-	BIT_CLEAR(&PORT_PT, PORT_PTS);
-	spi_transmit(PT_ADDRESS);
-	BIT_SET(&PORT_PT, PORT_PTS);
-	// send the remaining data
-	for(i=0;i<PT_FRAME_SIZE;i++) {
-		spi_transmit(buf[i]);
+
+	// the front buffer is being sent, keep the changes for the next commit
+	if(tx_busy || bus_lent)
+		return false;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		pending = dirty;
+		dirty = 0;
+	}
+
+	for(i=0;i<PT_BLOCKS;i++) {
+		if(!(pending & _BV(i)))
+			continue;
+
+		// drop updates which did not change anything, e.g. set and reset again before the tick
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			if(!memcmp(&front[i], &back[i], PT_FRAME_SIZE)) {
+				pending &= ~_BV(i);
+			} else {
+				memcpy(&front[i], &back[i], PT_FRAME_SIZE);
+			}
+		}
+	}
+
+	if(!pending)
+		return false;
+
+	// hand the changed blocks to the SPI interrupt and return right away
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		tx_queue = pending;
+		tx_busy = true;
+		pt6524_send_next();
+	}
+	return true;
+}
+
+bool pt6524_pending(void) {
+	return dirty && !tx_busy && !bus_lent;
+}
+
+bool pt6524_busy(void) {
+	return tx_busy;
+}
+
+bool pt6524_bus_acquire(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if(tx_busy || bus_lent)
+			return false;
+
+		// the other device polls the transfers itself
+		bus_lent = true;
+		SPCR &= ~_BV(SPIE);
 	}
+	return true;
 }
 
+void pt6524_bus_release(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		// a polled transfer that was not read back leaves SPIF set, which would raise the
+		// interrupt right away, reading SPSR and then SPDR clears it
+		if(SPSR & _BV(SPIF))
+			(void)SPDR;
+		SPCR |= _BV(SPIE);
+		bus_lent = false;
+	}
+}
+
+void pt6524_set_callback(pt6524_callback_t callback) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		tx_done = callback;
+	}
+}
+
+// starts the next queued block with its address byte, CE is low between blocks
+static void pt6524_send_next(void) {
+	uint8_t i;
+
+	for(i=0;i<PT_BLOCKS;i++) {
+		if(tx_queue & _BV(i))
+			break;
+	}
+	tx_queue &= ~_BV(i);
+	tx_data = front[i].data;
+	tx_count = PT_FRAME_SIZE + 1;
+
+	SPDR = PT_ADDRESS;
+}
+
+ISR(SPI_STC_vect) {
+	// not our transfer, there is no block to continue
+	if(!tx_busy)
+		return;
+
+	// the address has been sent, CE goes high for the display data
+	if(tx_count == PT_FRAME_SIZE + 1)
+		PORT_PT |= _BV(PORT_PTS);
+
+	if(--tx_count) {
+		SPDR = *tx_data++;
+		return;
+	}
+
+	// last byte sent, drop CE so the chip latches the block
+	PORT_PT &= ~_BV(PORT_PTS);
+
+	if(tx_queue) {
+		pt6524_send_next();
+		return;
+	}
+
+	tx_busy = false;
+	if(tx_done)
+		tx_done();
+}
@@ -0,0 +1,76 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef PT6524_H
+#define PT6524_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <avr/io.h>
+
+#include "../Board/Pins.h"
+
+// CE line of the PT6524, from the board pin map, may be overridden by the board configuration
+#ifndef PORT_PT
+	#define DDR_PT			BOARD_DDRREG(PIN_LCD_CE_PORT)
+	#define DDR_PTS			PIN_LCD_CE_BIT
+	#define PORT_PT			BOARD_PORTREG(PIN_LCD_CE_PORT)
+	#define PORT_PTS		PIN_LCD_CE_BIT
+#endif
+
+#define PT_DIGITS			51		// segment outputs SG1..SG51, each driving four commons
+#define PT_SEGMENTS			(PT_DIGITS * 4)	// display data bits D1..D204
+#define PT_BLOCKS			4		// serial transfers needed for the complete display
+#define PT_DIGITS_PER_BLOCK	13		// segment outputs carried by each transfer
+#define PT_SEGMENTS_PER_BLOCK	(PT_DIGITS_PER_BLOCK * 4)
+
+// called from the SPI interrupt once all queued blocks have been sent
+typedef void (*pt6524_callback_t)(void);
+
+void pt6524_init(void);
+
+// drawing into the back buffer, nothing is sent until pt6524_commit()
+void pt6524_clear(void);
+void pt6524_set_segment(uint8_t segment, bool on);
+void pt6524_set_digit(uint8_t digit, uint8_t coms);
+// reads back the commons of a segment output from the back buffer
+uint8_t pt6524_get_digit(uint8_t digit);
+void pt6524_set_display(bool on);
+
+// queues the blocks of the back buffer which differ from the displayed frame, the
+// SPI interrupt sends them in the background
+bool pt6524_commit(void);
+bool pt6524_pending(void);
+bool pt6524_busy(void);
+void pt6524_set_callback(pt6524_callback_t callback);
+
+// lends the SPI bus to another device on it, e.g. the Dataflash, false while a transfer
+// is running. The SPI interrupt is off until the bus is released, so the borrower must
+// poll its transfers and leave SPIF clear.
+bool pt6524_bus_acquire(void);
+void pt6524_bus_release(void);
+
+#endif
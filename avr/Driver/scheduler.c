@@ -0,0 +1,231 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#define SCHED_PRESCALER		64		// see SCHED_TIMESTAMP_NS
+#define SCHED_TOP			((F_CPU / SCHED_PRESCALER / 1000) - 1)
+#define SCHED_SOF_TOP		0xFF	// the timer only runs out if a SOF is missing
+
+_Static_assert(SCHED_TOP < SCHED_SOF_TOP, "the 1ms tick fits the 8 bit timer, with some slack for the SOF");
+_Static_assert(SCHED_TASKS <= 8, "overrun flags are one byte");
+
+typedef struct _sched_slot {
+	sched_task_t task;
+	uint16_t period;
+	uint16_t remaining;		// ticks until the task is due
+	uint16_t budget;
+	uint16_t wcet;
+	uint8_t priority;
+	uint8_t overruns;
+	uint8_t id;
+} sched_slot_t;
+
+// kept sorted by priority, so the table is simply run in order
+static sched_slot_t slots[SCHED_TASKS];
+static uint8_t count;
+
+static volatile uint8_t ticks;		// elapsed since the last sched_run
+static volatile uint16_t now;
+static uint8_t overrun_flags;
+static volatile bool sof_locked;	// the tick follows the USB start of frame
+
+void sched_init(void) {
+	// Timer 0, CTC mode, 1ms
+	OCR0A = SCHED_TOP;
+	TCCR0A = _BV(WGM01);
+	TCCR0B = _BV(CS01) | _BV(CS00);
+	TIMSK0 = _BV(OCIE0A);
+
+	// Timer 1, normal mode, no prescaler
+	TCCR1A = 0;
+	TCCR1B = _BV(CS10);
+}
+
+uint8_t sched_add(sched_task_t task, uint16_t period, uint8_t priority, uint16_t budget) {
+	sched_slot_t slot;
+	uint8_t i;
+
+	if(count == SCHED_TASKS)
+		return SCHED_NONE;
+
+	slot.task = task;
+	slot.period = period ? period : 1;
+	slot.remaining = slot.period;
+	slot.budget = budget;
+	slot.wcet = 0;
+	slot.priority = priority;
+	slot.overruns = 0;
+	slot.id = count;
+
+	// insert behind all tasks with the same or a higher priority
+	for(i=count;i && slots[i-1].priority > priority;i--) {
+		slots[i] = slots[i-1];
+	}
+	slots[i] = slot;
+	count++;
+
+	return slot.id;
+}
+
+void sched_run(void) {
+	sched_slot_t *slot;
+	uint16_t start;
+	uint16_t cycles;
+	uint8_t elapsed;
+	uint8_t i;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		elapsed = ticks;
+		ticks = 0;
+	}
+	if(!elapsed)
+		return;
+
+	for(i=0;i<count;i++) {
+		slot = &slots[i];
+
+		// a task which missed several periods only runs once
+		if(slot->remaining > elapsed) {
+			slot->remaining -= elapsed;
+			continue;
+		}
+		slot->remaining = slot->period;
+
+		start = sched_cycles();
+		slot->task();
+		cycles = sched_cycles() - start;
+
+		// the statistics are read from the USB interrupt
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			if(cycles > slot->wcet)
+				slot->wcet = cycles;
+			if(cycles > slot->budget) {
+				if(slot->overruns < 0xFF)
+					slot->overruns++;
+				overrun_flags |= _BV(slot->id);
+			}
+		}
+	}
+}
+
+bool sched_pending(void) {
+	return ticks;
+}
+
+uint16_t sched_now(void) {
+	uint16_t ms;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		ms = now;
+	}
+	return ms;
+}
+
+uint16_t sched_timestamp(void) {
+	uint16_t ms;
+	uint8_t count;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		ms = now;
+		count = TCNT0;
+		// the timer has just wrapped, but the tick has not been counted yet
+		if((TIFR0 & _BV(OCF0A)) && count < SCHED_TOP / 2)
+			ms++;
+	}
+	return ms * (SCHED_TOP + 1) + count;
+}
+
+uint16_t sched_cycles(void) {
+	uint16_t cycles;
+
+	// TCNT1 is read through the shared TEMP register
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		cycles = TCNT1;
+	}
+	return cycles;
+}
+
+void sched_get_stats(sched_stats_t *stats) {
+	uint8_t i;
+
+	memset(stats, 0, sizeof(*stats));
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		for(i=0;i<count;i++) {
+			stats->wcet[slots[i].id] = slots[i].wcet;
+			stats->overruns[slots[i].id] = slots[i].overruns;
+		}
+		stats->overrun_flags = overrun_flags;
+		stats->sof_locked = sof_locked;
+
+		overrun_flags = 0;
+	}
+}
+
+void sched_reset_stats(void) {
+	uint8_t i;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		for(i=0;i<count;i++) {
+			slots[i].wcet = 0;
+			slots[i].overruns = 0;
+		}
+		overrun_flags = 0;
+	}
+}
+
+static void sched_tick(void) {
+	if(ticks < 0xFF)
+		ticks++;
+	now++;
+}
+
+// called from the USB interrupt on every start of frame, the timer is restarted so
+// the tick stays in step with the host's 1kHz frame clock instead of the crystal
+void sched_sof(void) {
+	TCNT0 = 0;
+	TIFR0 = _BV(OCF0A);
+	if(!sof_locked) {
+		OCR0A = SCHED_SOF_TOP;
+		sof_locked = true;
+	}
+	sched_tick();
+}
+
+ISR(TIMER0_COMPA_vect) {
+	// no frames from the host (suspend, disconnect), the timer runs on its own again
+	if(sof_locked) {
+		OCR0A = SCHED_TOP;
+		sof_locked = false;
+	}
+	sched_tick();
+}
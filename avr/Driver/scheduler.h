@@ -0,0 +1,74 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCHED_TASKS		8		// slots in the task table
+#define SCHED_NONE		0xFF
+
+#define SCHED_TIMESTAMP_NS	(64 * 1000000000UL / F_CPU)	// one Timer 0 count
+
+// A task runs to completion from the main loop, once per period. Tasks due in the
+// same tick are run in priority order, 0 first.
+typedef void (*sched_task_t)(void);
+
+// Timer 0 gives the 1ms tick, Timer 1 runs free at F_CPU to count cycles
+void sched_init(void);
+
+// period is in ticks, budget in CPU cycles, returns the task id or SCHED_NONE
+uint8_t sched_add(sched_task_t task, uint16_t period, uint8_t priority, uint16_t budget);
+
+// locks the tick to the USB start of frame, falls back to the timer when SOFs stop
+void sched_sof(void);
+
+// runs all tasks which became due since the last call
+void sched_run(void);
+// true if a tick elapsed since the last sched_run
+bool sched_pending(void);
+
+// milliseconds since sched_init, wraps
+uint16_t sched_now(void);
+// fine grained time in SCHED_TIMESTAMP_NS units, wraps every 262ms at 16MHz
+uint16_t sched_timestamp(void);
+// free running CPU cycle counter, wraps every 4ms at 16MHz
+uint16_t sched_cycles(void);
+
+// run time statistics, indexed by task id
+typedef struct _sched_stats {
+	uint16_t wcet[SCHED_TASKS];		// longest run in cycles
+	uint8_t overruns[SCHED_TASKS];	// runs longer than the budget, saturating
+	uint8_t overrun_flags;			// one bit per task which overran since the last read
+	uint8_t sof_locked;				// the tick follows the USB start of frame
+} sched_stats_t;
+
+// fills in the statistics, and clears the overrun flags
+void sched_get_stats(sched_stats_t *stats);
+void sched_reset_stats(void);
+
+#endif
@@ -0,0 +1,161 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "settings.h"
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+#include <util/crc16.h>
+
+// CRC seed, bump when settings_t changes so older snapshots are ignored
+#define SETTINGS_FORMAT		0x02
+
+#define SEQUENCE_ERASED		0xFFFF
+
+typedef struct _settings_record {
+	uint16_t sequence;
+	settings_t settings;
+	uint8_t crc;			// over the sequence and the settings
+} settings_record_t;
+
+#define SLOTS	((E2END + 1) / sizeof(settings_record_t))
+
+// settings last saved, and whether they still have to be written
+static settings_t pending;
+static volatile bool dirty;
+static uint16_t first_change;
+static uint16_t last_change;
+
+// snapshot being written
+static settings_record_t record;
+static uint8_t record_slot;
+static uint8_t record_pos;
+static bool writing;
+
+static uint16_t sequence;
+
+static uint8_t record_crc(const settings_record_t *r) {
+	const uint8_t *data = (const uint8_t *)r;
+	uint8_t crc = SETTINGS_FORMAT;
+	uint8_t i;
+
+	for(i=0;i<offsetof(settings_record_t, crc);i++)
+		crc = _crc8_ccitt_update(crc, data[i]);
+	return crc;
+}
+
+static uint8_t *slot_address(uint8_t slot) {
+	return (uint8_t *)(slot * sizeof(settings_record_t));
+}
+
+bool settings_load(settings_t *settings) {
+	settings_record_t r;
+	bool found = false;
+	uint8_t slot = 0;
+	uint8_t i;
+
+	for(i=0;i<SLOTS;i++) {
+		eeprom_read_block(&r, slot_address(i), sizeof(r));
+		if(r.sequence == SEQUENCE_ERASED || r.crc != record_crc(&r))
+			continue;
+
+		// the sequence wraps, but all snapshots in the journal are within one lap of each other
+		if(found && (int16_t)(r.sequence - sequence) <= 0)
+			continue;
+
+		found = true;
+		slot = i;
+		sequence = r.sequence;
+		pending = r.settings;
+	}
+
+	// carry on after the latest snapshot
+	record_slot = found ? (slot + 1) % SLOTS : 0;
+
+	if(found)
+		*settings = pending;
+	return found;
+}
+
+void settings_save(const settings_t *settings) {
+	uint16_t now = sched_now();
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if(!memcmp(&pending, settings, sizeof(pending)))
+			return;
+
+		pending = *settings;
+		if(!dirty)
+			first_change = now;
+		last_change = now;
+		dirty = true;
+	}
+}
+
+void settings_task(void) {
+	uint16_t now;
+
+	if(writing) {
+		// a byte write takes ~3.4ms, never wait for it
+		if(!eeprom_is_ready())
+			return;
+
+		eeprom_update_byte(slot_address(record_slot) + record_pos, ((const uint8_t *)&record)[record_pos]);
+		if(++record_pos < sizeof(record))
+			return;
+
+		writing = false;
+		record_slot = (record_slot + 1) % SLOTS;
+		return;
+	}
+
+	if(!dirty)
+		return;
+
+	// coalesce bursts of changes, e.g. a knob being turned, into one snapshot
+	now = sched_now();
+	if((uint16_t)(now - last_change) < SETTINGS_DELAY_MS && (uint16_t)(now - first_change) < SETTINGS_MAX_DELAY_MS)
+		return;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		record.settings = pending;
+		dirty = false;
+	}
+
+	if(++sequence == SEQUENCE_ERASED)
+		sequence = 0;
+	record.sequence = sequence;
+	record.crc = record_crc(&record);
+
+	// the CRC goes last, so a snapshot is only valid once it is complete
+	record_pos = 0;
+	writing = true;
+}
@@ -0,0 +1,59 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gesture.h"
+
+// Settings journal in the EEPROM. Every save appends a complete snapshot with a sequence
+// number and a CRC to the next slot, going round the whole EEPROM, so each cell is only
+// written once per lap. A snapshot torn by a power loss fails its CRC, and the one
+// before it is used.
+#define SETTINGS_DELAY_MS		1000	// written once the settings have not changed for this long
+#define SETTINGS_MAX_DELAY_MS	10000	// but no later than this after the first unsaved change
+
+typedef struct _settings {
+	gesture_config_t gestures;
+	uint8_t marquee_speed;
+	uint8_t marquee_pause;
+	uint8_t marquee_mode;
+	uint8_t preset;			// last station recalled, PRESET_NONE if none
+	uint8_t knob_mode;		// a PROTOCOL_KNOB_* value
+} settings_t;
+
+// finds the latest snapshot in one pass over the journal, false if there is none and the
+// settings have been left alone
+bool settings_load(settings_t *settings);
+// queues the settings to be written, may be called from the USB interrupt
+void settings_save(const settings_t *settings);
+// writes a queued snapshot one byte per call while the EEPROM is ready, to be called
+// periodically from the main loop
+void settings_task(void);
+
+#endif
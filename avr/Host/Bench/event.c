@@ -0,0 +1,59 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "../bench.h"
+
+#include "Driver/event.h"
+
+static event_queue_t queue;
+
+// one event through the queue, put by the producer and taken by the consumer
+BENCH(event_put_get) {
+	event_t event;
+	uint32_t i;
+
+	bench_start();
+	for(i=0;i<iterations;i++) {
+		event_put(&queue, EVENT_KEY_DOWN, i);
+		event_get(&queue, &event);
+	}
+	bench_stop();
+}
+
+// events put in bursts until the queue is full, then all taken, as the main loop does
+// after a sleep. Each burst ends with the put which finds the queue full.
+BENCH(event_burst) {
+	event_t event;
+	uint32_t i;
+
+	bench_start();
+	for(i=0;i<iterations;i+=EVENT_QUEUE_SIZE) {
+		while(event_put(&queue, EVENT_KEY_DOWN, i))
+			;
+		while(event_get(&queue, &event))
+			;
+	}
+	bench_stop();
+}
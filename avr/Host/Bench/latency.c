@@ -0,0 +1,102 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "../bench.h"
+#include "../device.h"
+
+// emulated milliseconds since the device was connected
+static uint32_t now;
+
+// one frame of the bus: the start of frame is the device's tick, and the host polls the IN endpoint
+// every GENERIC_POLLING_MS frames, one packet per poll. Returns true once the last
+// packet of a report has arrived, the report is in state then.
+static bool latency_frame(RadioState_t *state, uint16_t *offset) {
+	int length;
+
+	mock_usb_sof();
+	device_run();
+	if(now++ % GENERIC_POLLING_MS)
+		return false;
+
+	length = mock_usb_in(GENERIC_IN_EPADDR, (uint8_t *)state + *offset);
+	if(length < 0)
+		return false;
+
+	*offset += length;
+	if(*offset < sizeof(RadioState_t))
+		return false;
+	*offset = 0;
+	return true;
+}
+
+// waits for the report which has the given key state, returns the frames it took
+static uint32_t latency_wait(uint8_t keys) {
+	RadioState_t state;
+	uint16_t offset = 0;
+	uint32_t frames = 0;
+
+	for(;;) {
+		frames++;
+		if(latency_frame(&state, &offset) && state.Keys == keys)
+			return frames;
+	}
+}
+
+// From a front panel key going down to the host holding the whole report, in frames
+// of 1ms, with the key pressed at every phase of the polling interval. The key is
+// debounced for four scans, then the report takes one poll per packet, so the legacy
+// profile and the full-speed profile differ by the polls of the extra packets.
+BENCH(latency_key_to_host) {
+	uint32_t total = 0;
+	uint32_t worst = 0;
+	uint32_t frames;
+	uint32_t i;
+	uint16_t ms;
+
+	device_boot();
+	device_connect();
+
+	bench_start();
+	for(i=0;i<iterations;i++) {
+		for(ms=0;ms<i%GENERIC_POLLING_MS;ms++) {
+			mock_usb_sof();
+			device_run();
+			now++;
+		}
+
+		mock_keys_set(BUTTONS_BUTTON1);
+		frames = latency_wait(BUTTONS_BUTTON1);
+		total += frames;
+		worst = MAX(worst, frames);
+
+		mock_keys_set(0);
+		latency_wait(0);
+	}
+	bench_stop();
+
+	bench_metric("ms avg", (double)total / iterations, true);
+	bench_metric("ms max", worst, true);
+	bench_metric("packets", (sizeof(RadioState_t) + GENERIC_EPSIZE - 1) / GENERIC_EPSIZE, true);
+}
@@ -0,0 +1,74 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "../bench.h"
+
+#include <avr/interrupt.h>
+
+#include "Driver/pt6524.h"
+
+// one run of the SPI interrupt per byte sent, with a full display frame queued each
+// time the last one is done, including the mocked shift of the SPI data register
+BENCH(pt6524_spi_interrupt) {
+	uint32_t frames = 0;
+	uint32_t i;
+
+	pt6524_init();
+
+	bench_start();
+	for(i=0;i<iterations;i++) {
+		if(!pt6524_busy()) {
+			pt6524_set_display(frames++ & 1);
+			pt6524_commit();
+		}
+		mock_spi_shift();
+		SPI_STC_vect();
+	}
+	bench_stop();
+
+	bench_metric("frames", frames, true);
+}
+
+// a commit of a single changed block, and the nine bytes sending it
+BENCH(pt6524_commit_block) {
+	uint32_t i;
+
+	pt6524_init();
+	while(pt6524_busy()) {
+		mock_spi_shift();
+		SPI_STC_vect();
+	}
+
+	bench_start();
+	for(i=0;i<iterations;i++) {
+		pt6524_set_digit(20, i & 0x0F);
+		pt6524_commit();
+		while(pt6524_busy()) {
+			mock_spi_shift();
+			SPI_STC_vect();
+		}
+	}
+	bench_stop();
+}
@@ -0,0 +1,76 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "../bench.h"
+#include "../device.h"
+
+// USB interrupts per iteration on all endpoints, and packets on the one measured. Each
+// interrupt moves at most one packet between an endpoint FIFO and the device state block
+// or a command report buffer, the one run which finds nothing to send stops the IN
+// endpoint interrupt.
+static void report_interrupts(uint8_t address, uint32_t iterations) {
+	mock_usb_stats_t stats;
+
+	mock_usb_get_stats(address, &stats);
+	bench_metric("interrupts", stats.interrupts, false);
+	bench_metric("packets", address & ENDPOINT_DIR_IN ? stats.in_packets : stats.out_packets, false);
+}
+
+// one command report on the interrupt OUT endpoint, parsed and executed
+BENCH(report_out_set_leds) {
+	const uint8_t commands[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x01 };
+	RadioState_t state;
+	uint32_t i;
+
+	device_boot();
+	device_connect();
+
+	bench_start();
+	for(i=0;i<iterations;i++) {
+		device_command(commands, sizeof(commands));
+		device_state(&state);
+	}
+	bench_stop();
+
+	report_interrupts(GENERIC_OUT_EPADDR, iterations);
+}
+
+// one state report on the interrupt IN endpoint
+BENCH(report_in_state) {
+	RadioState_t state;
+	uint32_t i;
+
+	device_boot();
+	device_connect();
+
+	bench_start();
+	for(i=0;i<iterations;i++) {
+		HID_NotifyStateChanged();
+		device_state(&state);
+	}
+	bench_stop();
+
+	report_interrupts(GENERIC_IN_EPADDR, iterations);
+}
@@ -0,0 +1,89 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Host mock of the LUFA common header: the attribute and helper macros the firmware
+// uses, with the values of LUFA 140928.
+
+#ifndef MOCK_LUFA_COMMON_H
+#define MOCK_LUFA_COMMON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#define ARCH_AVR8						0
+#define ARCH							ARCH_AVR8
+
+#define ATTR_NO_RETURN					__attribute__((noreturn))
+#define ATTR_WARN_UNUSED_RESULT			__attribute__((warn_unused_result))
+#define ATTR_NON_NULL_PTR_ARG(...)		__attribute__((nonnull(__VA_ARGS__)))
+#define ATTR_NAKED
+#define ATTR_NO_INLINE					__attribute__((noinline))
+#define ATTR_ALWAYS_INLINE				__attribute__((always_inline))
+#define ATTR_PURE						__attribute__((pure))
+#define ATTR_CONST						__attribute__((const))
+#define ATTR_WEAK						__attribute__((weak))
+#define ATTR_ALIAS(Func)				__attribute__((alias(#Func)))
+#define ATTR_PACKED						__attribute__((packed))
+#define ATTR_ALIGNED(Bytes)				__attribute__((aligned(Bytes)))
+#define ATTR_INIT_SECTION(SectionIndex)
+#define ATTR_NO_INIT
+
+#define MACROS							do
+#define MACROE							while (0)
+
+#define MIN(x, y)						(((x) < (y)) ? (x) : (y))
+#define MAX(x, y)						(((x) > (y)) ? (x) : (y))
+
+#define CPU_TO_LE16(x)					(x)
+#define LE16_TO_CPU(x)					(x)
+
+#define GCC_FORCE_POINTER_ACCESS(StructPtr)
+#define GCC_MEMORY_BARRIER()			__asm__ __volatile__("" ::: "memory")
+
+typedef uint8_t uint_reg_t;
+
+static inline void GlobalInterruptEnable(void) {
+	mock_interrupts = 1;
+}
+
+static inline void GlobalInterruptDisable(void) {
+	mock_interrupts = 0;
+}
+
+static inline uint_reg_t GetGlobalInterruptMask(void) {
+	return mock_interrupts;
+}
+
+static inline void SetGlobalInterruptMask(const uint_reg_t GlobalIntState) {
+	mock_interrupts = GlobalIntState;
+}
+
+#endif
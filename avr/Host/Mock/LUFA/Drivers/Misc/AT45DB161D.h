@@ -0,0 +1,66 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Host mock of the LUFA Atmel Dataflash command set, with the values of LUFA 140928.
+
+#ifndef MOCK_LUFA_AT45DB161D_H
+#define MOCK_LUFA_AT45DB161D_H
+
+#define DF_STATUS_READY						(1 << 7)
+#define DF_STATUS_COMPMISMATCH				(1 << 6)
+#define DF_STATUS_SECTORPROTECTION_ON		(1 << 1)
+#define DF_STATUS_BINARYPAGESIZE_ON			(1 << 0)
+
+#define DF_MANUFACTURER_ATMEL				0x1F
+
+#define DF_CMD_GETSTATUS					0xD7
+#define DF_CMD_POWERDOWN					0xB9
+#define DF_CMD_WAKEUP						0xAB
+
+#define DF_CMD_MAINMEMTOBUFF1				0x53
+#define DF_CMD_MAINMEMTOBUFF2				0x55
+#define DF_CMD_MAINMEMTOBUFF1COMP			0x60
+#define DF_CMD_MAINMEMTOBUFF2COMP			0x61
+#define DF_CMD_AUTOREWRITEBUFF1				0x58
+#define DF_CMD_AUTOREWRITEBUFF2				0x59
+
+#define DF_CMD_MAINMEMPAGEREAD				0xD2
+#define DF_CMD_CONTARRAYREAD_LF				0x03
+#define DF_CMD_BUFF1READ_LF					0xD1
+#define DF_CMD_BUFF2READ_LF					0xD3
+
+#define DF_CMD_BUFF1WRITE					0x84
+#define DF_CMD_BUFF2WRITE					0x87
+#define DF_CMD_BUFF1TOMAINMEMWITHERASE		0x83
+#define DF_CMD_BUFF2TOMAINMEMWITHERASE		0x86
+#define DF_CMD_BUFF1TOMAINMEM				0x88
+#define DF_CMD_BUFF2TOMAINMEM				0x89
+#define DF_CMD_MAINMEMPAGETHROUGHBUFF1		0x82
+#define DF_CMD_MAINMEMPAGETHROUGHBUFF2		0x85
+
+#define DF_CMD_PAGEERASE					0x81
+#define DF_CMD_BLOCKERASE					0x50
+
+#endif
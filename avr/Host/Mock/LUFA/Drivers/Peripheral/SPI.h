@@ -0,0 +1,89 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Host mock of the LUFA SPI master driver. SPI_Init() sets up the registers as LUFA
+// does, the byte transfers go to the devices on the mocked bus, see Mock/spi.c. As on
+// the chip, a byte that is not read back from SPDR leaves SPIF set.
+
+#ifndef MOCK_LUFA_SPI_H
+#define MOCK_LUFA_SPI_H
+
+#include <LUFA/Common/Common.h>
+
+#define SPI_USE_DOUBLESPEED				(1 << SPE)
+
+#define SPI_SPEED_FCPU_DIV_2			SPI_USE_DOUBLESPEED
+#define SPI_SPEED_FCPU_DIV_4			0
+#define SPI_SPEED_FCPU_DIV_8			(SPI_USE_DOUBLESPEED | (1 << SPR0))
+#define SPI_SPEED_FCPU_DIV_16			(1 << SPR0)
+#define SPI_SPEED_FCPU_DIV_32			(SPI_USE_DOUBLESPEED | (1 << SPR1))
+#define SPI_SPEED_FCPU_DIV_64			(1 << SPR1)
+#define SPI_SPEED_FCPU_DIV_128			((1 << SPR0) | (1 << SPR1))
+
+#define SPI_SCK_LEAD_RISING				(0 << CPOL)
+#define SPI_SCK_LEAD_FALLING			(1 << CPOL)
+#define SPI_SAMPLE_LEADING				(0 << CPHA)
+#define SPI_SAMPLE_TRAILING				(1 << CPHA)
+#define SPI_ORDER_MSB_FIRST				(0 << DORD)
+#define SPI_ORDER_LSB_FIRST				(1 << DORD)
+#define SPI_MODE_SLAVE					(0 << MSTR)
+#define SPI_MODE_MASTER					(1 << MSTR)
+
+uint8_t mock_spi_transfer(uint8_t byte, bool read);
+
+static inline void SPI_Init(const uint8_t SPIOptions) {
+	DDRB |= (1 << 1) | (1 << 2);
+	DDRB &= ~(1 << 3);
+	PORTB |= (1 << 3);
+
+	SPCR = ((1 << SPE) | SPIOptions);
+
+	if (SPIOptions & SPI_USE_DOUBLESPEED)
+	  SPSR |= (1 << SPI2X);
+	else
+	  SPSR &= ~(1 << SPI2X);
+}
+
+static inline void SPI_Disable(void) {
+	DDRB &= ~((1 << 1) | (1 << 2));
+	PORTB &= ~((1 << 0) | (1 << 3));
+
+	SPCR = 0;
+	SPSR = 0;
+}
+
+static inline uint8_t SPI_TransferByte(const uint8_t Byte) {
+	return mock_spi_transfer(Byte, true);
+}
+
+static inline void SPI_SendByte(const uint8_t Byte) {
+	mock_spi_transfer(Byte, false);
+}
+
+static inline uint8_t SPI_ReceiveByte(void) {
+	return mock_spi_transfer(0x00, true);
+}
+
+#endif
@@ -0,0 +1,201 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Host mock of the LUFA USB device stack. The constants have the values of LUFA 140928,
+// the endpoint calls work on the endpoint model in Mock/usb.c, which the tests drive
+// as the USB host through Mock/mock.h.
+
+#ifndef MOCK_LUFA_USB_H
+#define MOCK_LUFA_USB_H
+
+#include <LUFA/Common/Common.h>
+
+#define USB_CAN_BE_DEVICE
+#define USB_DEVICE_ONLY
+
+#define ENDPOINT_DIR_MASK					0x80
+#define ENDPOINT_DIR_OUT					0x00
+#define ENDPOINT_DIR_IN						0x80
+#define ENDPOINT_EPNUM_MASK					0x0F
+#define ENDPOINT_CONTROLEP					0
+#define ENDPOINT_TOTAL_ENDPOINTS			7
+
+#define EP_TYPE_CONTROL						0x00
+#define EP_TYPE_ISOCHRONOUS					0x01
+#define EP_TYPE_BULK						0x02
+#define EP_TYPE_INTERRUPT					0x03
+
+#define FIXED_CONTROL_ENDPOINT_SIZE			8
+
+#define REQDIR_HOSTTODEVICE					(0 << 7)
+#define REQDIR_DEVICETOHOST					(1 << 7)
+#define REQTYPE_STANDARD					(0 << 5)
+#define REQTYPE_CLASS						(1 << 5)
+#define REQTYPE_VENDOR						(2 << 5)
+#define REQREC_DEVICE						(0 << 0)
+#define REQREC_INTERFACE					(1 << 0)
+#define REQREC_ENDPOINT						(2 << 0)
+#define REQREC_OTHER						(3 << 0)
+
+enum USB_Device_States_t
+{
+	DEVICE_STATE_Unattached                   = 0,
+	DEVICE_STATE_Powered                      = 1,
+	DEVICE_STATE_Default                      = 2,
+	DEVICE_STATE_Addressed                    = 3,
+	DEVICE_STATE_Configured                   = 4,
+	DEVICE_STATE_Suspended                    = 5,
+};
+
+enum HID_ClassRequests_t
+{
+	HID_REQ_GetReport                         = 0x01,
+	HID_REQ_GetIdle                           = 0x02,
+	HID_REQ_GetProtocol                       = 0x03,
+	HID_REQ_SetReport                         = 0x09,
+	HID_REQ_SetIdle                           = 0x0A,
+	HID_REQ_SetProtocol                       = 0x0B,
+};
+
+enum HID_ReportItemTypes_t
+{
+	HID_REPORT_ITEM_In                        = 0,
+	HID_REPORT_ITEM_Out                       = 1,
+	HID_REPORT_ITEM_Feature                   = 2,
+};
+
+enum Endpoint_Stream_RW_ErrorCodes_t
+{
+	ENDPOINT_RWSTREAM_NoError                 = 0,
+	ENDPOINT_RWSTREAM_EndpointStalled         = 1,
+	ENDPOINT_RWSTREAM_DeviceDisconnected      = 2,
+	ENDPOINT_RWSTREAM_BusSuspended            = 3,
+	ENDPOINT_RWSTREAM_Timeout                 = 4,
+	ENDPOINT_RWSTREAM_IncompleteTransfer      = 5,
+};
+
+enum Endpoint_ControlStream_RW_ErrorCodes_t
+{
+	ENDPOINT_RWCSTREAM_NoError                = 0,
+	ENDPOINT_RWCSTREAM_HostAborted            = 1,
+	ENDPOINT_RWCSTREAM_DeviceDisconnected     = 2,
+	ENDPOINT_RWCSTREAM_BusSuspended           = 3,
+};
+
+typedef struct
+{
+	uint8_t  bmRequestType;
+	uint8_t  bRequest;
+	uint16_t wValue;
+	uint16_t wIndex;
+	uint16_t wLength;
+} ATTR_PACKED USB_Request_Header_t;
+
+typedef struct
+{
+	uint8_t Size;
+	uint8_t Type;
+} ATTR_PACKED USB_Descriptor_Header_t;
+
+typedef struct
+{
+	USB_Descriptor_Header_t Header;
+	uint16_t TotalConfigurationSize;
+	uint8_t  TotalInterfaces;
+	uint8_t  ConfigurationNumber;
+	uint8_t  ConfigurationStrIndex;
+	uint8_t  ConfigAttributes;
+	uint8_t  MaxPowerConsumption;
+} ATTR_PACKED USB_Descriptor_Configuration_Header_t;
+
+typedef struct
+{
+	USB_Descriptor_Header_t Header;
+	uint8_t InterfaceNumber;
+	uint8_t AlternateSetting;
+	uint8_t TotalEndpoints;
+	uint8_t Class;
+	uint8_t SubClass;
+	uint8_t Protocol;
+	uint8_t InterfaceStrIndex;
+} ATTR_PACKED USB_Descriptor_Interface_t;
+
+typedef struct
+{
+	USB_Descriptor_Header_t Header;
+	uint8_t  EndpointAddress;
+	uint8_t  Attributes;
+	uint16_t EndpointSize;
+	uint8_t  PollingIntervalMS;
+} ATTR_PACKED USB_Descriptor_Endpoint_t;
+
+typedef struct
+{
+	USB_Descriptor_Header_t Header;
+	uint16_t HIDSpec;
+	uint8_t  CountryCode;
+	uint8_t  TotalReportDescriptors;
+	uint8_t  HIDReportType;
+	uint16_t HIDReportLength;
+} ATTR_PACKED USB_HID_Descriptor_HID_t;
+
+extern USB_Request_Header_t USB_ControlRequest;
+extern volatile uint8_t USB_DeviceState;
+
+// device
+void USB_Init(void);
+void USB_Device_ProcessControlRequest(void);
+void USB_Device_EnableSOFEvents(void);
+void USB_Device_DisableSOFEvents(void);
+uint16_t USB_Device_GetFrameNumber(void);
+
+// endpoints, on the endpoint selected by UENUM
+bool Endpoint_ConfigureEndpoint(const uint8_t Address, const uint8_t Type, const uint16_t Size, const uint8_t Banks);
+void Endpoint_SelectEndpoint(const uint8_t Address);
+uint8_t Endpoint_GetCurrentEndpoint(void);
+uint16_t Endpoint_BytesInEndpoint(void);
+bool Endpoint_IsINReady(void);
+bool Endpoint_IsOUTReceived(void);
+bool Endpoint_IsSETUPReceived(void);
+bool Endpoint_IsReadWriteAllowed(void);
+void Endpoint_ClearSETUP(void);
+void Endpoint_ClearIN(void);
+void Endpoint_ClearOUT(void);
+void Endpoint_StallTransaction(void);
+void Endpoint_ClearStatusStage(void);
+uint8_t Endpoint_Read_8(void);
+void Endpoint_Write_8(const uint8_t Data);
+uint8_t Endpoint_Write_Control_Stream_LE(const void* const Buffer, uint16_t Length);
+uint8_t Endpoint_Read_Control_Stream_LE(void* const Buffer, uint16_t Length);
+
+// application events, called by the stack
+void EVENT_USB_Device_Connect(void);
+void EVENT_USB_Device_Disconnect(void);
+void EVENT_USB_Device_Reset(void);
+void EVENT_USB_Device_ConfigurationChanged(void);
+void EVENT_USB_Device_ControlRequest(void);
+void EVENT_USB_Device_StartOfFrame(void);
+
+#endif
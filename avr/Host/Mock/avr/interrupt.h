@@ -0,0 +1,53 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Host mock of <avr/interrupt.h>. Interrupt handlers become plain functions, which the
+// tests call to raise the interrupt. The global interrupt flag is kept per thread, so
+// a stress test can run an "ISR" and the main loop side by side.
+
+#ifndef MOCK_AVR_INTERRUPT_H
+#define MOCK_AVR_INTERRUPT_H
+
+#include <stdint.h>
+
+extern _Thread_local uint8_t mock_interrupts;
+
+#define sei()				(mock_interrupts = 1)
+#define cli()				(mock_interrupts = 0)
+
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR(vector, ...)	void vector(void)
+
+// vectors used by the firmware
+void USB_COM_vect(void);
+void SPI_STC_vect(void);
+void TIMER0_COMPA_vect(void);
+void TIMER3_COMPA_vect(void);
+void TIMER3_COMPB_vect(void);
+void TIMER3_COMPC_vect(void);
+void PCINT0_vect(void);
+
+#endif
@@ -0,0 +1,148 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Host mock of <avr/io.h> for the ATmega32U4. The I/O space is an array, and every
+// register access goes through mock_sfr(), so the mocked peripherals can see the pins
+// before they are read and notice chip select edges, see Mock/mock.h.
+
+#ifndef MOCK_AVR_IO_H
+#define MOCK_AVR_IO_H
+
+#include <stdint.h>
+
+#include <avr/sfr_defs.h>
+
+#define E2END		0x3FF
+#define RAMEND		0xAFF
+
+// ports, in the I/O space
+#define PINB		_SFR_IO8(0x03)
+#define DDRB		_SFR_IO8(0x04)
+#define PORTB		_SFR_IO8(0x05)
+#define PINC		_SFR_IO8(0x06)
+#define DDRC		_SFR_IO8(0x07)
+#define PORTC		_SFR_IO8(0x08)
+#define PIND		_SFR_IO8(0x09)
+#define DDRD		_SFR_IO8(0x0A)
+#define PORTD		_SFR_IO8(0x0B)
+#define PINE		_SFR_IO8(0x0C)
+#define DDRE		_SFR_IO8(0x0D)
+#define PORTE		_SFR_IO8(0x0E)
+#define PINF		_SFR_IO8(0x0F)
+#define DDRF		_SFR_IO8(0x10)
+#define PORTF		_SFR_IO8(0x11)
+
+#define TIFR0		_SFR_IO8(0x15)
+#define TIFR1		_SFR_IO8(0x16)
+#define TIFR3		_SFR_IO8(0x18)
+#define PCIFR		_SFR_IO8(0x1B)
+#define EECR		_SFR_IO8(0x1F)
+#define TCCR0A		_SFR_IO8(0x24)
+#define TCCR0B		_SFR_IO8(0x25)
+#define TCNT0		_SFR_IO8(0x26)
+#define OCR0A		_SFR_IO8(0x27)
+#define OCR0B		_SFR_IO8(0x28)
+#define SPCR		_SFR_IO8(0x2C)
+#define SPSR		_SFR_IO8(0x2D)
+#define SPDR		_SFR_IO8(0x2E)
+#define SMCR		_SFR_IO8(0x33)
+#define MCUSR		_SFR_IO8(0x34)
+#define MCUCR		_SFR_IO8(0x35)
+
+// extended I/O space
+#define WDTCSR		_SFR_MEM8(0x60)
+#define CLKPR		_SFR_MEM8(0x61)
+#define PCICR		_SFR_MEM8(0x68)
+#define PCMSK0		_SFR_MEM8(0x6B)
+#define TIMSK0		_SFR_MEM8(0x6E)
+#define TIMSK1		_SFR_MEM8(0x6F)
+#define TIMSK3		_SFR_MEM8(0x71)
+#define TCCR1A		_SFR_MEM8(0x80)
+#define TCCR1B		_SFR_MEM8(0x81)
+#define TCNT1		_SFR_MEM16(0x84)
+#define OCR1A		_SFR_MEM16(0x88)
+#define TCCR3A		_SFR_MEM8(0x90)
+#define TCCR3B		_SFR_MEM8(0x91)
+#define TCNT3		_SFR_MEM16(0x94)
+#define OCR3A		_SFR_MEM16(0x98)
+#define OCR3B		_SFR_MEM16(0x9A)
+#define OCR3C		_SFR_MEM16(0x9C)
+#define UDFNUM		_SFR_MEM16(0xE4)
+
+// the endpoint registers are banked by UENUM, the USB mock keeps one set per endpoint
+extern volatile uint8_t mock_usb_epnum;
+extern volatile uint8_t mock_usb_ueienx[8];
+
+#define UENUM		mock_usb_epnum
+#define UEIENX		mock_usb_ueienx[mock_usb_epnum]
+
+// bits
+#define PB0			0
+#define PB1			1
+#define PB2			2
+#define PB3			3
+#define PB4			4
+#define PB5			5
+#define PB6			6
+#define PB7			7
+#define DDB4		4
+
+#define OCF0A		1
+#define WGM01		1
+#define CS00		0
+#define CS01		1
+#define CS02		2
+#define OCIE0A		1
+#define CS10		0
+#define WGM32		3
+#define CS31		1
+#define OCIE3A		1
+#define OCIE3B		2
+#define OCIE3C		3
+#define PCIE0		0
+
+#define SPIE		7
+#define SPE			6
+#define DORD		5
+#define MSTR		4
+#define CPOL		3
+#define CPHA		2
+#define SPR1		1
+#define SPR0		0
+#define SPIF		7
+#define SPI2X		0
+
+#define WDRF		3
+#define JTRF		4
+#define JTD			7
+
+#define TXINE		0
+#define RXOUTE		2
+#define RXSTPE		3
+
+// avr-gcc builtins
+#define __builtin_avr_delay_cycles(n)	((void)(n))
+
+#endif
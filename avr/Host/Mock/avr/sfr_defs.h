@@ -0,0 +1,45 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Host mock of <avr/sfr_defs.h>, register accesses go through the peripheral mocks.
+
+#ifndef MOCK_AVR_SFR_DEFS_H
+#define MOCK_AVR_SFR_DEFS_H
+
+#include <stdint.h>
+
+#define _BV(bit)			(1 << (bit))
+
+// returns the register cell after letting the mocked peripherals update it
+volatile uint8_t *mock_sfr(uint8_t address);
+
+#define _SFR_MEM8(address)	(*mock_sfr(address))
+#define _SFR_MEM16(address)	(*(volatile uint16_t *)mock_sfr(address))
+#define _SFR_IO8(address)	_SFR_MEM8((address) + 0x20)
+
+#define bit_is_set(sfr, bit)	((sfr) & _BV(bit))
+#define bit_is_clear(sfr, bit)	(!((sfr) & _BV(bit)))
+
+#endif
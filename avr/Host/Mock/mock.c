@@ -0,0 +1,214 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Register file, pins and EEPROM of the host mocks. Every register access runs
+// mock_sfr(), which first lets the peripherals see what the firmware wrote since the
+// last access, then updates the register about to be read.
+
+#include "mock.h"
+#include "mock_bus.h"
+
+#include <string.h>
+#include <time.h>
+
+#include <avr/eeprom.h>
+#include <avr/sleep.h>
+#include <LUFA/Drivers/Board/Buttons.h>
+
+#define PORTS		5
+#define PIN_REG(p)	(0x23 + 3 * (p))
+#define DDR_REG(p)	(0x24 + 3 * (p))
+#define PORT_REG(p)	(0x25 + 3 * (p))
+#define TCNT1_REG	0x84
+
+volatile uint8_t mock_io[0x100];
+_Thread_local uint8_t mock_interrupts;
+
+uint8_t mock_eeprom[E2END + 1];
+
+static uint8_t pins_driven[PORTS];		// pins driven from outside
+static uint8_t pins_level[PORTS];
+static uint8_t pins_shadow[PORTS];		// PINx as last set up, a change is a toggle write
+static uint8_t port_shadow[PORTS];
+static uint8_t keys;
+
+static void (*sleep_handler)(void);
+
+static int32_t eeprom_fail = -1;
+static uint32_t eeprom_writes;
+
+uint64_t mock_ns(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+// level of an input: driven from outside, pulled low by a key on a selected row,
+// else the pull-up
+static uint8_t pins_input(uint8_t port) {
+	uint8_t levels = mock_io[PORT_REG(port)];
+	uint8_t rows = mock_io[DDR_REG(BUTTONS_ROW_PORT)] & ~mock_io[PORT_REG(BUTTONS_ROW_PORT)];
+	uint8_t i;
+
+	levels = (levels & ~pins_driven[port]) | (pins_level[port] & pins_driven[port]);
+
+	if(port == BUTTONS_COLUMN_PORT) {
+		for(i=0;i<BUTTONS_ROWS*BUTTONS_COLUMNS;i++) {
+			if((keys & _BV(i)) && (rows & _BV(BUTTONS_ROW_SHIFT + i / BUTTONS_COLUMNS)))
+				levels &= ~_BV(BUTTONS_COLUMN_SHIFT + i % BUTTONS_COLUMNS);
+		}
+	}
+	return levels;
+}
+
+void mock_settle(void) {
+	uint8_t port;
+
+	for(port=0;port<PORTS;port++) {
+		// writing ones to PINx toggles the outputs
+		if(mock_io[PIN_REG(port)] != pins_shadow[port]) {
+			mock_io[PORT_REG(port)] ^= mock_io[PIN_REG(port)];
+			mock_io[PIN_REG(port)] = pins_shadow[port];
+		}
+		if(mock_io[PORT_REG(port)] != port_shadow[port]) {
+			port_shadow[port] = mock_io[PORT_REG(port)];
+			if(port == BOARD_PORT_B)
+				mock_spi_port(port_shadow[port]);
+		}
+	}
+}
+
+volatile uint8_t *mock_sfr(uint8_t address) {
+	uint8_t port;
+	uint16_t cycles;
+
+	mock_settle();
+
+	if(address >= PIN_REG(0) && address < PIN_REG(PORTS) && (address - PIN_REG(0)) % 3 == 0) {
+		port = (address - PIN_REG(0)) / 3;
+		pins_shadow[port] = (mock_io[PORT_REG(port)] & mock_io[DDR_REG(port)]) |
+		                    (pins_input(port) & ~mock_io[DDR_REG(port)]);
+		mock_io[address] = pins_shadow[port];
+	} else if(address == TCNT1_REG) {
+		// timer 1 runs free at F_CPU
+		cycles = mock_ns() * 16 / 1000;
+		mock_io[TCNT1_REG] = cycles;
+		mock_io[TCNT1_REG + 1] = cycles >> 8;
+	}
+	mock_spi_sfr(address);
+	return &mock_io[address];
+}
+
+void mock_reset(void) {
+	memset((void *)mock_io, 0, sizeof(mock_io));
+	memset(pins_driven, 0, sizeof(pins_driven));
+	memset(pins_level, 0, sizeof(pins_level));
+	memset(pins_shadow, 0, sizeof(pins_shadow));
+	memset(port_shadow, 0, sizeof(port_shadow));
+	keys = 0;
+
+	memset(mock_eeprom, 0xFF, sizeof(mock_eeprom));
+	eeprom_fail = -1;
+	eeprom_writes = 0;
+
+	mock_interrupts = 0;
+	sleep_handler = 0;
+	mock_spi_reset();
+	mock_usb_reset();
+}
+
+void mock_on_sleep(void (*handler)(void)) {
+	sleep_handler = handler;
+}
+
+void mock_sleep(void) {
+	if(sleep_handler)
+		sleep_handler();
+}
+
+void mock_pins_set(uint8_t port, uint8_t mask, uint8_t levels) {
+	mock_settle();
+	pins_driven[port] |= mask;
+	pins_level[port] = (pins_level[port] & ~mask) | (levels & mask);
+}
+
+void mock_keys_set(uint8_t pressed) {
+	keys = pressed;
+}
+
+void mock_eeprom_fail_after(int32_t writes) {
+	eeprom_fail = writes;
+}
+
+uint32_t mock_eeprom_writes(void) {
+	return eeprom_writes;
+}
+
+bool eeprom_is_ready(void) {
+	return true;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address) {
+	return mock_eeprom[(uintptr_t)address & E2END];
+}
+
+void eeprom_read_block(void *data, const void *address, size_t length) {
+	size_t i;
+
+	for(i=0;i<length;i++)
+		((uint8_t *)data)[i] = eeprom_read_byte((const uint8_t *)address + i);
+}
+
+void eeprom_write_byte(uint8_t *address, uint8_t value) {
+	if(eeprom_fail == 0)
+		return;
+	if(eeprom_fail > 0)
+		eeprom_fail--;
+
+	eeprom_writes++;
+	mock_eeprom[(uintptr_t)address & E2END] = value;
+}
+
+void eeprom_update_byte(uint8_t *address, uint8_t value) {
+	if(eeprom_read_byte(address) != value)
+		eeprom_write_byte(address, value);
+}
+
+char *utoa(unsigned int value, char *str, int radix) {
+	char digits[17];
+	uint8_t i = 0;
+	uint8_t j = 0;
+
+	do {
+		digits[i++] = "0123456789abcdef"[value % radix];
+		value /= radix;
+	} while(value);
+
+	while(i)
+		str[j++] = digits[--i];
+	str[j] = 0;
+	return str;
+}
@@ -0,0 +1,128 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Peripheral mocks for the host build. The firmware sees the mocked registers and the
+// mocked LUFA calls, the tests drive the other side through the functions below: the
+// pins, the EEPROM, the SPI bus with the PT6524 and the Dataflash, and the USB host.
+
+#ifndef MOCK_H
+#define MOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <avr/io.h>
+#include <LUFA/Drivers/USB/USB.h>
+
+#define MOCK_SPI_LOG		4096	// bytes kept by the SPI capture
+
+#define MOCK_FLASH_PAGES	2048
+#define MOCK_FLASH_PAGE		264
+
+// register file without the peripheral hooks, indexed by data space address
+extern volatile uint8_t mock_io[0x100];
+
+// puts all peripherals into their reset state, done before every test
+void mock_reset(void);
+
+// host time in ns, monotonic
+uint64_t mock_ns(void);
+
+// the firmware's main loop goes to sleep, the handler takes over until the next interrupt
+void mock_on_sleep(void (*handler)(void));
+
+// pins driven from outside, port is a BOARD_PORT_* value
+void mock_pins_set(uint8_t port, uint8_t mask, uint8_t levels);
+// front panel keys held down, one bit per key as in BUTTONS_BUTTON1
+void mock_keys_set(uint8_t keys);
+
+// EEPROM, erased by mock_reset(). After the given number of byte writes, further
+// writes are lost as if power had failed, -1 for no failure.
+extern uint8_t mock_eeprom[E2END + 1];
+void mock_eeprom_fail_after(int32_t writes);
+uint32_t mock_eeprom_writes(void);
+
+// SPI bytes sent from the SPI interrupt, with the PT6524 CE level while each was sent
+typedef struct _mock_spi_log {
+	uint8_t data[MOCK_SPI_LOG];
+	bool ce[MOCK_SPI_LOG];
+	size_t count;
+} mock_spi_log_t;
+
+extern mock_spi_log_t mock_spi_log;
+
+// takes the byte written to SPDR as sent, as the SPI hardware does before it raises
+// the SPI interrupt, returns it
+uint8_t mock_spi_shift(void);
+// shifts out the byte in flight, then takes the SPI interrupt if it is enabled and SPIF
+// is set: clears SPIF as the vector does and returns true, the caller runs SPI_STC_vect()
+bool mock_spi_interrupt(void);
+
+// AT45DB041D on the SPI bus, erased by mock_reset(). Programming a page keeps the chip
+// busy for the given number of status reads. Power fails during the page program after
+// the given number: that page is left erased and the chip stops answering, -1 for no
+// failure.
+extern uint8_t mock_flash[MOCK_FLASH_PAGES][MOCK_FLASH_PAGE];
+void mock_flash_present(bool present);
+void mock_flash_busy(uint8_t status_reads);
+void mock_flash_fail_after(int32_t programs);
+uint32_t mock_flash_programs(void);
+
+// USB host. The device is attached and reset, then configured, which runs the
+// application's USB event handlers.
+void mock_usb_attach(void);
+void mock_usb_configure(void);
+void mock_usb_detach(void);
+void mock_usb_suspend(void);
+void mock_usb_resume(void);
+// start of frame, advances the frame number
+void mock_usb_sof(void);
+// raises the USB endpoint interrupt for as long as an enabled endpoint interrupt is pending
+void mock_usb_service(void);
+
+// sends one OUT packet, false if the endpoint has no free bank (NAK)
+bool mock_usb_out(uint8_t address, const void *data, uint8_t length);
+// polls an IN endpoint, returns the packet length, or -1 if the device NAKs
+int mock_usb_in(uint8_t address, void *data);
+// runs a control transfer, data holds the OUT data or receives the IN data, returns the
+// length of the data stage, or -1 if the request was stalled or not completed
+int mock_usb_control(const USB_Request_Header_t *request, void *data);
+// lets the host give up on the next control transfer after the given number of bytes of
+// its OUT data stage: once the device waits for more, the host suspends the bus, or sends
+// a new SETUP, which the device stalls as it cannot handle it
+void mock_usb_abort_control(uint16_t after, bool suspend);
+
+typedef struct _mock_usb_stats {
+	uint32_t in_packets;	// packets taken by the host
+	uint32_t in_naks;		// polls with no packet ready
+	uint32_t out_packets;	// packets accepted by the device
+	uint32_t out_naks;		// packets refused for lack of a free bank
+	uint32_t interrupts;	// USB_COM_vect runs
+} mock_usb_stats_t;
+
+void mock_usb_get_stats(uint8_t address, mock_usb_stats_t *stats);
+
+#endif
@@ -0,0 +1,243 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// SPI bus of the host mocks: an AT45DB041D Dataflash behind FLASH_CS, and a capture of
+// what the SPI interrupt sends to the PT6524 behind LCD_CE.
+//
+// The polled LUFA calls go straight to the bus, so the register accesses come from the
+// interrupt driven display driver: an SPDR access right after a read of SPSR with SPIF
+// set is taken as the read that clears SPIF, any other as a write that starts a byte.
+
+#include "mock.h"
+#include "mock_bus.h"
+
+#include <string.h>
+
+#include <LUFA/Drivers/Board/Dataflash.h>
+
+#define FLASH_BUFFERS		2
+#define FLASH_STATUS		0x1C	// density code of the AT45DB041D
+
+#define SPCR_REG			0x4C
+#define SPSR_REG			0x4D
+#define SPDR_REG			0x4E
+
+mock_spi_log_t mock_spi_log;
+uint8_t mock_flash[MOCK_FLASH_PAGES][MOCK_FLASH_PAGE];
+
+static struct {
+	bool present;
+	bool selected;
+	uint8_t command[4];		// opcode and address bytes
+	uint8_t length;
+	uint16_t page;			// address of the command
+	uint16_t offset;
+	uint8_t buffer[FLASH_BUFFERS][MOCK_FLASH_PAGE];
+	uint8_t busy;			// status reads until the chip is ready
+	uint8_t program_time;
+	int32_t fail;			// programs until power fails
+	bool off;
+	uint32_t programs;
+} flash;
+
+static struct {
+	bool sending;			// a byte written to SPDR is on its way out
+	bool status;			// the last register access read SPSR with SPIF set
+} bus;
+
+void mock_spi_reset(void) {
+	memset(&mock_spi_log, 0, sizeof(mock_spi_log));
+	memset(mock_flash, 0xFF, sizeof(mock_flash));
+	memset(&flash, 0, sizeof(flash));
+	memset(&bus, 0, sizeof(bus));
+	flash.present = true;
+	flash.fail = -1;
+}
+
+static void flash_program(uint8_t buffer) {
+	if(flash.off)
+		return;
+
+	flash.programs++;
+	memset(mock_flash[flash.page], 0xFF, MOCK_FLASH_PAGE);
+	if(flash.fail == 0) {
+		flash.off = true;	// power failed between the erase and the program
+		return;
+	}
+	if(flash.fail > 0)
+		flash.fail--;
+
+	memcpy(mock_flash[flash.page], flash.buffer[buffer], MOCK_FLASH_PAGE);
+	flash.busy = flash.program_time;
+}
+
+// a command ends when the chip is deselected
+static void flash_finish(void) {
+	if(flash.length < 4)
+		return;
+
+	switch(flash.command[0]) {
+	case DF_CMD_MAINMEMTOBUFF1:
+	case DF_CMD_MAINMEMTOBUFF2:
+		memcpy(flash.buffer[flash.command[0] == DF_CMD_MAINMEMTOBUFF2], mock_flash[flash.page], MOCK_FLASH_PAGE);
+		break;
+	case DF_CMD_BUFF1TOMAINMEMWITHERASE:
+	case DF_CMD_BUFF2TOMAINMEMWITHERASE:
+		flash_program(flash.command[0] == DF_CMD_BUFF2TOMAINMEMWITHERASE);
+		break;
+	}
+}
+
+void mock_spi_port(uint8_t levels) {
+	bool selected = !(levels & PIN_FLASH_CS_MASK);
+
+	if(selected == flash.selected)
+		return;
+
+	if(!selected)
+		flash_finish();
+	flash.selected = selected;
+	flash.length = 0;
+}
+
+static uint8_t flash_transfer(uint8_t byte) {
+	uint8_t result = 0xFF;
+	uint8_t buffer;
+
+	if(!flash.present || flash.off)
+		return 0xFF;
+
+	if(flash.length < 4) {
+		flash.command[flash.length++] = byte;
+		if(flash.length == 4) {
+			flash.page = (((flash.command[1] << 8) | flash.command[2]) >> 1) & (MOCK_FLASH_PAGES - 1);
+			flash.offset = ((flash.command[2] & 1) << 8) | flash.command[3];
+		}
+		if(flash.command[0] != DF_CMD_GETSTATUS || flash.length == 1)
+			return result;
+		flash.length = 1;	// status is read repeatedly
+	}
+
+	switch(flash.command[0]) {
+	case DF_CMD_GETSTATUS:
+		result = FLASH_STATUS;
+		if(flash.busy)
+			flash.busy--;
+		else
+			result |= DF_STATUS_READY;
+		break;
+	case DF_CMD_CONTARRAYREAD_LF:
+		result = mock_flash[flash.page][flash.offset];
+		if(++flash.offset == MOCK_FLASH_PAGE) {
+			flash.offset = 0;
+			flash.page = (flash.page + 1) & (MOCK_FLASH_PAGES - 1);
+		}
+		break;
+	case DF_CMD_BUFF1WRITE:
+	case DF_CMD_BUFF2WRITE:
+		buffer = flash.command[0] == DF_CMD_BUFF2WRITE;
+		flash.buffer[buffer][flash.offset] = byte;
+		if(++flash.offset == MOCK_FLASH_PAGE)
+			flash.offset = 0;
+		break;
+	}
+	return result;
+}
+
+uint8_t mock_spi_transfer(uint8_t byte, bool read) {
+	uint8_t result = 0xFF;
+
+	mock_settle();
+
+	if(flash.selected)
+		result = flash_transfer(byte);
+
+	// LUFA polls SPIF, reading SPDR afterwards clears it
+	mock_io[SPDR_REG] = result;
+	if(read)
+		mock_io[SPSR_REG] &= ~_BV(SPIF);
+	else
+		mock_io[SPSR_REG] |= _BV(SPIF);
+	bus.status = false;
+	return result;
+}
+
+void mock_spi_sfr(uint8_t address) {
+	bool status = bus.status;
+
+	bus.status = false;
+	if(address == SPSR_REG) {
+		bus.status = mock_io[SPSR_REG] & _BV(SPIF);
+	} else if(address == SPDR_REG) {
+		if(status)
+			mock_io[SPSR_REG] &= ~_BV(SPIF);
+		else
+			bus.sending = true;
+	}
+}
+
+uint8_t mock_spi_shift(void) {
+	size_t i = mock_spi_log.count;
+
+	mock_settle();
+
+	if(i < MOCK_SPI_LOG) {
+		mock_spi_log.data[i] = mock_io[SPDR_REG];
+		mock_spi_log.ce[i] = mock_io[0x25] & PIN_LCD_CE_MASK;
+		mock_spi_log.count++;
+	}
+	bus.sending = false;
+	mock_io[SPSR_REG] |= _BV(SPIF);
+	return mock_io[SPDR_REG];
+}
+
+bool mock_spi_interrupt(void) {
+	mock_settle();
+
+	if(bus.sending)
+		mock_spi_shift();
+	if(!(mock_io[SPCR_REG] & _BV(SPIE)) || !(mock_io[SPSR_REG] & _BV(SPIF)))
+		return false;
+
+	mock_io[SPSR_REG] &= ~_BV(SPIF);
+	return true;
+}
+
+void mock_flash_present(bool present) {
+	flash.present = present;
+}
+
+void mock_flash_busy(uint8_t status_reads) {
+	flash.program_time = status_reads;
+}
+
+void mock_flash_fail_after(int32_t programs) {
+	flash.fail = programs;
+}
+
+uint32_t mock_flash_programs(void) {
+	mock_settle();
+	return flash.programs;
+}
@@ -0,0 +1,507 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// USB device controller and host of the host mocks. Endpoints have one or two banks as
+// configured, the host side fills and empties them through the functions in mock.h and
+// raises USB_COM_vect while an enabled endpoint interrupt is pending. Control transfers
+// go through the application's EVENT_USB_Device_ControlRequest(), unhandled requests
+// are stalled as in LUFA.
+
+#include "mock.h"
+#include "mock_bus.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ENDPOINTS			8
+#define BANK_SIZE			64
+#define CONTROL_DATA		512		// longest control data stage
+#define SERVICE_LIMIT		1000	// interrupts per service call
+#define SPIN_LIMIT			1000000	// polls of an empty control endpoint
+
+typedef struct {
+	uint8_t data[BANK_SIZE];
+	uint8_t length;
+} bank_t;
+
+typedef struct {
+	bool configured;
+	uint8_t direction;
+	uint16_t size;
+	uint8_t banks;
+	bank_t bank[2];
+	uint8_t head;			// bank the host or the device takes next
+	uint8_t count;			// banks filled
+	uint8_t position;		// in the bank the device works on
+	mock_usb_stats_t stats;
+} endpoint_t;
+
+USB_Request_Header_t USB_ControlRequest;
+volatile uint8_t USB_DeviceState;
+
+volatile uint8_t mock_usb_epnum;
+volatile uint8_t mock_usb_ueienx[ENDPOINTS];
+
+static endpoint_t endpoints[ENDPOINTS];
+static uint32_t interrupts;
+static uint16_t frame;
+static bool sof_events;
+static uint8_t resume_state;
+
+static struct {
+	USB_Request_Header_t request;
+	bool setup;				// SETUP not yet cleared by the device
+	uint8_t out[CONTROL_DATA];
+	uint16_t out_length;	// data stage sent by the host
+	uint16_t out_position;
+	uint16_t packet_end;	// end of the OUT packet the device is reading
+	uint8_t in[CONTROL_DATA];
+	uint16_t in_length;
+	bool complete;			// status stage done
+	bool stalled;
+	bool abort;				// host stops the data stage
+	uint16_t abort_after;
+	bool abort_suspend;
+	uint32_t polls;
+} control;
+
+void mock_usb_reset(void) {
+	memset(endpoints, 0, sizeof(endpoints));
+	memset((void *)mock_usb_ueienx, 0, sizeof(mock_usb_ueienx));
+	memset(&control, 0, sizeof(control));
+	memset(&USB_ControlRequest, 0, sizeof(USB_ControlRequest));
+	USB_DeviceState = DEVICE_STATE_Unattached;
+	mock_usb_epnum = 0;
+	interrupts = 0;
+	frame = 0;
+	sof_events = false;
+}
+
+static endpoint_t *current(void) {
+	return &endpoints[mock_usb_epnum & (ENDPOINTS - 1)];
+}
+
+static bool is_control(void) {
+	return (mock_usb_epnum & (ENDPOINTS - 1)) == ENDPOINT_CONTROLEP;
+}
+
+// the host gives up on the control transfer in progress once the device waits for more
+static void control_abort(void) {
+	control.abort = false;
+
+	if(control.abort_suspend) {
+		mock_usb_suspend();
+		return;
+	}
+
+	memset(&control.request, 0, sizeof(control.request));
+	control.request.bmRequestType = REQDIR_DEVICETOHOST;
+	control.out_length = control.out_position = control.packet_end = 0;
+	control.setup = true;
+}
+
+static void control_packet(void) {
+	control.packet_end = MIN(control.out_position + FIXED_CONTROL_ENDPOINT_SIZE, control.out_length);
+}
+
+void USB_Init(void) {
+	mock_usb_reset();
+}
+
+void USB_Device_ProcessControlRequest(void) {
+	memcpy(&USB_ControlRequest, &control.request, sizeof(USB_ControlRequest));
+	control_packet();
+
+	EVENT_USB_Device_ControlRequest();
+
+	if(control.setup) {
+		control.setup = false;
+		control.stalled = true;
+	}
+}
+
+void USB_Device_EnableSOFEvents(void) {
+	sof_events = true;
+}
+
+void USB_Device_DisableSOFEvents(void) {
+	sof_events = false;
+}
+
+uint16_t USB_Device_GetFrameNumber(void) {
+	return frame;
+}
+
+bool Endpoint_ConfigureEndpoint(const uint8_t Address, const uint8_t Type, const uint16_t Size, const uint8_t Banks) {
+	endpoint_t *ep = &endpoints[Address & ENDPOINT_EPNUM_MASK & (ENDPOINTS - 1)];
+
+	if(Size > BANK_SIZE || !Banks || Banks > 2)
+		return false;
+
+	memset(ep, 0, offsetof(endpoint_t, stats));
+	ep->configured = true;
+	ep->direction = Address & ENDPOINT_DIR_MASK;
+	ep->size = Size;
+	ep->banks = Banks;
+	return true;
+}
+
+void Endpoint_SelectEndpoint(const uint8_t Address) {
+	mock_usb_epnum = Address & ENDPOINT_EPNUM_MASK;
+}
+
+uint8_t Endpoint_GetCurrentEndpoint(void) {
+	return mock_usb_epnum | current()->direction;
+}
+
+uint16_t Endpoint_BytesInEndpoint(void) {
+	endpoint_t *ep = current();
+
+	if(is_control())
+		return control.packet_end - control.out_position;
+	if(ep->direction == ENDPOINT_DIR_IN)
+		return ep->position;
+	return ep->count ? ep->bank[ep->head].length - ep->position : 0;
+}
+
+bool Endpoint_IsINReady(void) {
+	endpoint_t *ep = current();
+
+	if(is_control())
+		return true;
+	return ep->configured && ep->count < ep->banks;
+}
+
+bool Endpoint_IsOUTReceived(void) {
+	endpoint_t *ep = current();
+
+	if(!is_control())
+		return ep->configured && ep->count;
+
+	if(control.out_position < control.out_length) {
+		control.polls = 0;
+		return true;
+	}
+
+	if(control.abort) {
+		control_abort();
+	} else if(++control.polls == SPIN_LIMIT) {
+		fprintf(stderr, "device waits for control data which the host never sends\n");
+		abort();
+	}
+	return false;
+}
+
+bool Endpoint_IsSETUPReceived(void) {
+	return is_control() && control.setup;
+}
+
+bool Endpoint_IsReadWriteAllowed(void) {
+	endpoint_t *ep = current();
+
+	if(ep->direction == ENDPOINT_DIR_IN)
+		return ep->position < ep->size;
+	return Endpoint_BytesInEndpoint() > 0;
+}
+
+void Endpoint_ClearSETUP(void) {
+	if(is_control())
+		control.setup = false;
+}
+
+void Endpoint_ClearIN(void) {
+	endpoint_t *ep = current();
+
+	if(is_control()) {
+		// a zero length packet after an OUT data stage is the status stage
+		if(!(control.request.bmRequestType & REQDIR_DEVICETOHOST))
+			control.complete = true;
+		return;
+	}
+
+	if(ep->count == ep->banks)
+		return;
+	ep->bank[(ep->head + ep->count) % ep->banks].length = ep->position;
+	ep->count++;
+	ep->position = 0;
+}
+
+void Endpoint_ClearOUT(void) {
+	endpoint_t *ep = current();
+
+	if(is_control()) {
+		if(control.request.bmRequestType & REQDIR_DEVICETOHOST) {
+			control.complete = true;
+		} else {
+			control.out_position = control.packet_end;
+			control_packet();
+		}
+		return;
+	}
+
+	if(!ep->count)
+		return;
+	ep->head = (ep->head + 1) % ep->banks;
+	ep->count--;
+	ep->position = 0;
+}
+
+void Endpoint_StallTransaction(void) {
+	if(is_control())
+		control.stalled = true;
+}
+
+void Endpoint_ClearStatusStage(void) {
+	control.complete = true;
+}
+
+uint8_t Endpoint_Read_8(void) {
+	endpoint_t *ep = current();
+
+	if(is_control())
+		return control.out_position < control.packet_end ? control.out[control.out_position++] : 0;
+	if(!ep->count || ep->position >= ep->bank[ep->head].length)
+		return 0;
+	return ep->bank[ep->head].data[ep->position++];
+}
+
+void Endpoint_Write_8(const uint8_t Data) {
+	endpoint_t *ep = current();
+
+	if(is_control()) {
+		if(control.in_length < CONTROL_DATA)
+			control.in[control.in_length++] = Data;
+		return;
+	}
+	if(ep->count < ep->banks && ep->position < ep->size)
+		ep->bank[(ep->head + ep->count) % ep->banks].data[ep->position++] = Data;
+}
+
+uint8_t Endpoint_Write_Control_Stream_LE(const void* const Buffer, uint16_t Length) {
+	const uint8_t *data = Buffer;
+
+	if(control.setup)
+		return ENDPOINT_RWCSTREAM_HostAborted;
+
+	Length = MIN(Length, control.request.wLength);
+	while(Length--)
+		Endpoint_Write_8(*data++);
+	return ENDPOINT_RWCSTREAM_NoError;
+}
+
+uint8_t Endpoint_Read_Control_Stream_LE(void* const Buffer, uint16_t Length) {
+	uint8_t *data = Buffer;
+
+	while(Length) {
+		if(control.setup)
+			return ENDPOINT_RWCSTREAM_HostAborted;
+		if(USB_DeviceState == DEVICE_STATE_Unattached)
+			return ENDPOINT_RWCSTREAM_DeviceDisconnected;
+		if(USB_DeviceState == DEVICE_STATE_Suspended)
+			return ENDPOINT_RWCSTREAM_BusSuspended;
+
+		if(Endpoint_IsOUTReceived()) {
+			while(Length && Endpoint_BytesInEndpoint()) {
+				*data++ = Endpoint_Read_8();
+				Length--;
+			}
+			Endpoint_ClearOUT();
+		}
+	}
+	return ENDPOINT_RWCSTREAM_NoError;
+}
+
+// host side
+
+static bool pending(void) {
+	uint8_t i;
+	endpoint_t *ep;
+
+	if(control.setup && (mock_usb_ueienx[ENDPOINT_CONTROLEP] & _BV(RXSTPE)))
+		return true;
+
+	for(i=1;i<ENDPOINTS;i++) {
+		ep = &endpoints[i];
+		if(!ep->configured)
+			continue;
+		if(ep->direction == ENDPOINT_DIR_IN && ep->count < ep->banks && (mock_usb_ueienx[i] & _BV(TXINE)))
+			return true;
+		if(ep->direction == ENDPOINT_DIR_OUT && ep->count && (mock_usb_ueienx[i] & _BV(RXOUTE)))
+			return true;
+	}
+	return false;
+}
+
+void mock_usb_service(void) {
+	uint16_t i;
+
+	for(i=0;i<SERVICE_LIMIT && pending();i++) {
+		interrupts++;
+		USB_COM_vect();
+	}
+}
+
+void mock_usb_attach(void) {
+	USB_DeviceState = DEVICE_STATE_Powered;
+	EVENT_USB_Device_Connect();
+
+	// bus reset, the library sets up the control endpoint
+	memset(endpoints, 0, sizeof(endpoints));
+	memset((void *)mock_usb_ueienx, 0, sizeof(mock_usb_ueienx));
+	Endpoint_ConfigureEndpoint(ENDPOINT_CONTROLEP, EP_TYPE_CONTROL, FIXED_CONTROL_ENDPOINT_SIZE, 1);
+	USB_DeviceState = DEVICE_STATE_Default;
+	EVENT_USB_Device_Reset();
+	USB_DeviceState = DEVICE_STATE_Addressed;
+}
+
+void mock_usb_configure(void) {
+	uint8_t i;
+
+	if(USB_DeviceState == DEVICE_STATE_Unattached)
+		mock_usb_attach();
+
+	for(i=1;i<ENDPOINTS;i++) {
+		endpoints[i].configured = false;
+		mock_usb_ueienx[i] = 0;
+	}
+
+	USB_DeviceState = DEVICE_STATE_Configured;
+	EVENT_USB_Device_ConfigurationChanged();
+	mock_usb_service();
+}
+
+void mock_usb_detach(void) {
+	USB_DeviceState = DEVICE_STATE_Unattached;
+	EVENT_USB_Device_Disconnect();
+}
+
+void mock_usb_suspend(void) {
+	if(USB_DeviceState != DEVICE_STATE_Suspended)
+		resume_state = USB_DeviceState;
+	USB_DeviceState = DEVICE_STATE_Suspended;
+}
+
+void mock_usb_resume(void) {
+	if(USB_DeviceState == DEVICE_STATE_Suspended)
+		USB_DeviceState = resume_state;
+}
+
+void mock_usb_sof(void) {
+	frame = (frame + 1) & 0x7FF;
+	if(sof_events && USB_DeviceState != DEVICE_STATE_Unattached)
+		EVENT_USB_Device_StartOfFrame();
+}
+
+bool mock_usb_out(uint8_t address, const void *data, uint8_t length) {
+	endpoint_t *ep = &endpoints[address & (ENDPOINTS - 1)];
+	bank_t *bank;
+
+	mock_usb_service();
+
+	if(!ep->configured || ep->direction != ENDPOINT_DIR_OUT || length > ep->size) {
+		ep->stats.out_naks++;
+		return false;
+	}
+	if(ep->count == ep->banks) {
+		ep->stats.out_naks++;
+		return false;
+	}
+
+	bank = &ep->bank[(ep->head + ep->count) % ep->banks];
+	memcpy(bank->data, data, length);
+	bank->length = length;
+	ep->count++;
+	ep->stats.out_packets++;
+
+	mock_usb_service();
+	return true;
+}
+
+int mock_usb_in(uint8_t address, void *data) {
+	endpoint_t *ep = &endpoints[address & (ENDPOINTS - 1)];
+	bank_t *bank;
+	int length;
+
+	mock_usb_service();
+
+	if(!ep->configured || ep->direction != ENDPOINT_DIR_IN || !ep->count) {
+		ep->stats.in_naks++;
+		return -1;
+	}
+
+	bank = &ep->bank[ep->head];
+	length = bank->length;
+	memcpy(data, bank->data, length);
+	ep->head = (ep->head + 1) % ep->banks;
+	ep->count--;
+	ep->stats.in_packets++;
+
+	mock_usb_service();
+	return length;
+}
+
+int mock_usb_control(const USB_Request_Header_t *request, void *data) {
+	bool out = !(request->bmRequestType & REQDIR_DEVICETOHOST);
+
+	if(USB_DeviceState == DEVICE_STATE_Unattached || request->wLength > CONTROL_DATA)
+		return -1;
+
+	mock_settle();
+	memcpy(&control.request, request, sizeof(control.request));
+	control.out_length = out ? request->wLength : 0;
+	if(out && control.abort)
+		control.out_length = MIN(control.out_length, control.abort_after);
+	if(control.out_length)
+		memcpy(control.out, data, control.out_length);
+	control.out_position = control.packet_end = 0;
+	control.in_length = 0;
+	control.complete = control.stalled = false;
+	control.polls = 0;
+	control.setup = true;
+
+	endpoints[ENDPOINT_CONTROLEP].stats.out_packets++;
+	mock_usb_service();
+
+	control.abort = false;
+	if(control.setup || control.stalled || !control.complete)
+		return -1;
+	if(out)
+		return control.out_position;
+
+	memcpy(data, control.in, control.in_length);
+	return control.in_length;
+}
+
+void mock_usb_abort_control(uint16_t after, bool suspend) {
+	control.abort = true;
+	control.abort_after = after;
+	control.abort_suspend = suspend;
+}
+
+void mock_usb_get_stats(uint8_t address, mock_usb_stats_t *stats) {
+	*stats = endpoints[address & (ENDPOINTS - 1)].stats;
+	stats->interrupts = interrupts;
+}
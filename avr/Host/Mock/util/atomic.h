@@ -0,0 +1,54 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Host mock of <util/atomic.h>. As in avr-libc the interrupt flag is restored by a
+// cleanup handler, so a block may be left with return or break.
+
+#ifndef MOCK_UTIL_ATOMIC_H
+#define MOCK_UTIL_ATOMIC_H
+
+#include <stdint.h>
+
+#include <avr/interrupt.h>
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+
+static inline uint8_t mock_atomic_enter(void) {
+	uint8_t saved = mock_interrupts;
+
+	mock_interrupts = 0;
+	return saved;
+}
+
+static inline void mock_atomic_leave(const uint8_t *saved) {
+	mock_interrupts = *saved;
+}
+
+#define ATOMIC_BLOCK(type) \
+	for(uint8_t mock_saved __attribute__((cleanup(mock_atomic_leave))) = mock_atomic_enter(), \
+	    mock_once = 1; mock_once; mock_once = 0)
+
+#endif
@@ -0,0 +1,279 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "../test.h"
+#include "../device.h"
+
+#include "Driver/encoder.h"
+
+static const uint8_t quadrature[4] = { 3, 1, 0, 2 };	// AB states of one detent clockwise
+static uint8_t position;
+
+static void encoder_set(uint8_t ab) {
+	mock_pins_set(PIN_ENC_A_PORT, PIN_ENC_A_MASK | PIN_ENC_B_MASK,
+	              ((ab & 2) ? PIN_ENC_A_MASK : 0) | ((ab & 1) ? PIN_ENC_B_MASK : 0));
+}
+
+// turns the knob by the given number of detents, all within the same millisecond
+static void encoder_turn(int16_t detents) {
+	uint8_t i;
+
+	while(detents) {
+		for(i=0;i<4;i++) {
+			position = (position + (detents > 0 ? 1 : 3)) & 3;
+			encoder_set(quadrature[position]);
+			PCINT0_vect();
+		}
+		detents += (detents > 0) ? -1 : 1;
+	}
+}
+
+static int32_t encoder_take_all(void) {
+	int32_t total = 0;
+	int8_t steps;
+
+	while((steps = encoder_take()) != 0)
+		total += steps;
+	return total;
+}
+
+TEST(encoder_counts_detents) {
+	event_queue_t events = {0};
+
+	encoder_set(quadrature[0]);
+	encoder_init(&events);
+
+	encoder_turn(1);
+	CHECK(encoder_pending());
+	CHECK(encoder_take() > 0);
+	CHECK(!encoder_pending());
+
+	encoder_turn(-1);
+	CHECK(encoder_take() < 0);
+}
+
+TEST(encoder_sum_saturates_clockwise) {
+	event_queue_t events = {0};
+
+	encoder_set(quadrature[0]);
+	encoder_init(&events);
+
+	// fast turns count 8 steps per detent, this is well past the range of the sum
+	encoder_turn(5000);
+	CHECK_EQ(INT16_MAX - INT16_MAX % 8, encoder_take_all());
+}
+
+TEST(encoder_sum_saturates_counterclockwise) {
+	event_queue_t events = {0};
+
+	encoder_set(quadrature[0]);
+	encoder_init(&events);
+
+	encoder_turn(-5000);
+	CHECK_EQ(INT16_MIN - INT16_MIN % 8, encoder_take_all());
+}
+
+TEST(encoder_cleared_on_configure) {
+	RadioState_t state;
+
+	encoder_set(quadrature[0]);
+	device_boot();
+
+	// turned before any host was there
+	encoder_turn(3);
+	mock_usb_configure();
+	device_run();
+
+	CHECK(device_state(&state));
+	CHECK_EQ(0, state.Encoder);
+}
+
+// takes the Consumer Control reports sent so far, returns the volume steps they carry
+static int16_t encoder_volume(void) {
+	int16_t volume = 0;
+	uint8_t report;
+
+	while(mock_usb_in(CONSUMER_IN_EPADDR, &report) == 1) {
+		if(report & CONSUMER_VOLUME_UP)
+			volume++;
+		if(report & CONSUMER_VOLUME_DOWN)
+			volume--;
+		device_run();
+	}
+	return volume;
+}
+
+TEST(encoder_tunes_without_volume) {
+	RadioState_t state;
+
+	encoder_set(quadrature[0]);
+	device_boot();
+	device_connect();
+
+	encoder_turn(2);
+	device_run();
+	CHECK(device_state(&state));
+	CHECK(state.Encoder > 0);
+	CHECK_EQ(0, encoder_volume());
+}
+
+TEST(encoder_volume_when_enabled) {
+	const uint8_t volume[] = { PROTOCOL_CMD_KNOB_MODE, 1, PROTOCOL_KNOB_VOLUME };
+	const uint8_t tune[] = { PROTOCOL_CMD_KNOB_MODE, 1, PROTOCOL_KNOB_TUNE };
+	RadioState_t state;
+
+	encoder_set(quadrature[0]);
+	device_boot();
+	device_connect();
+
+	// the knob is still reported for tuning, and its accelerated steps turn the volume as well
+	CHECK(device_command(volume, sizeof(volume)));
+	encoder_turn(-2);
+	device_run();
+	CHECK(device_state(&state));
+	CHECK(state.Encoder < 0);
+	CHECK_EQ(state.Encoder, encoder_volume());
+
+	CHECK(device_command(tune, sizeof(tune)));
+	encoder_turn(2);
+	device_run();
+	CHECK_EQ(0, encoder_volume());
+}
+
+// Edge traces in Test/Traces, one "time_us,A,B" line per change of the lines as a logic
+// analyser exports them, with the expected net detents and number of detent events in
+// "# detents:" and "# events:" comments.
+#define TRACE_DIR			"Test/Traces"
+#define TRACE_ISR_LATENCY	4		// us from a pin change to the pins being read, ~60 cycles
+
+typedef struct {
+	int32_t detents;
+	uint32_t events;
+} trace_result_t;
+
+static void trace_collect(event_queue_t *events, trace_result_t *result) {
+	event_t event;
+
+	while(event_get(events, &event)) {
+		result->detents += ((int8_t)event.data > 0) ? 1 : -1;
+		result->events++;
+	}
+}
+
+// Replays a trace on the encoder lines. A change raises the pin change interrupt, which
+// reads the lines a little later, so edges closer than that are seen together, as the
+// firmware would see them. Timer ticks are raised as the trace time passes.
+static bool trace_replay(const char *path, trace_result_t *expected, trace_result_t *result) {
+	event_queue_t events = {0};
+	char line[80];
+	FILE *file;
+	uint32_t time;
+	uint32_t ms = 0;
+	uint32_t isr_at = 0;
+	bool isr_pending = false;
+	unsigned a;
+	unsigned b;
+	bool first = true;
+
+	file = fopen(path, "r");
+	if(!file)
+		return false;
+
+	memset(result, 0, sizeof(*result));
+	while(fgets(line, sizeof(line), file)) {
+		if(sscanf(line, "# detents: %d", &expected->detents) == 1 || sscanf(line, "# events: %u", &expected->events) == 1)
+			continue;
+		if(line[0] == '#' || sscanf(line, "%u,%u,%u", &time, &a, &b) != 3)
+			continue;
+
+		if(isr_pending && time > isr_at) {
+			PCINT0_vect();
+			trace_collect(&events, result);
+			isr_pending = false;
+		}
+		for(;ms<time/1000;ms++)
+			TIMER0_COMPA_vect();
+
+		encoder_set((a ? 2 : 0) | (b ? 1 : 0));
+		if(first) {
+			// the lines at rest before the trace starts
+			encoder_init(&events);
+			first = false;
+		} else if(!isr_pending) {
+			isr_pending = true;
+			isr_at = time + TRACE_ISR_LATENCY;
+		}
+	}
+	if(isr_pending)
+		PCINT0_vect();
+	trace_collect(&events, result);
+
+	fclose(file);
+	return true;
+}
+
+TEST(encoder_traces_replayed_without_missed_steps) {
+	trace_result_t expected = {0};
+	trace_result_t result = {0};
+	struct dirent *entry;
+	char path[300];
+	char message[340];
+	DIR *dir;
+	int traces = 0;
+	int status;
+
+	dir = opendir(TRACE_DIR);
+	CHECK(dir != NULL);
+
+	// every trace from power on, as in its own process
+	while((entry = readdir(dir)) != NULL) {
+		if(!strstr(entry->d_name, ".csv"))
+			continue;
+
+		snprintf(path, sizeof(path), "%s/%s", TRACE_DIR, entry->d_name);
+		fflush(stdout);
+		if(fork() == 0) {
+			CHECK(trace_replay(path, &expected, &result));
+			snprintf(message, sizeof(message), "%s net detents", path);
+			if(result.detents != expected.detents)
+				test_fail(__FILE__, __LINE__, message, expected.detents, result.detents);
+			snprintf(message, sizeof(message), "%s detent events", path);
+			if(result.events != expected.events)
+				test_fail(__FILE__, __LINE__, message, expected.events, result.events);
+			_exit(0);
+		}
+		wait(&status);
+		CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+		traces++;
+	}
+	closedir(dir);
+	CHECK(traces > 0);
+}
@@ -0,0 +1,91 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "../test.h"
+
+#include "Driver/event.h"
+
+#define STRESS_EVENTS	2000000ul
+
+static event_queue_t queue;
+
+// stands in for an interrupt handler, numbers its events in type and data, and tries
+// again when the queue is full. Both sides yield while they wait, so that the test
+// also makes progress on a single CPU, where only preemption interleaves them.
+static void *event_producer(void *arg) {
+	uint32_t i;
+
+	for(i=0;i<STRESS_EVENTS;i++) {
+		while(!event_put(&queue, i >> 8, i & 0xFF))
+			sched_yield();
+	}
+	return NULL;
+}
+
+TEST(event_queue_threads_lose_nothing) {
+	pthread_t producer;
+	event_t event;
+	uint32_t expected = 0;
+	uint16_t number;
+
+	CHECK_EQ(0, pthread_create(&producer, NULL, event_producer, NULL));
+
+	// the main loop side, every event arrives once and in order
+	while(expected < STRESS_EVENTS) {
+		if(!event_get(&queue, &event)) {
+			sched_yield();
+			continue;
+		}
+
+		number = (event.type << 8) | event.data;
+		if(number != (uint16_t)expected)
+			test_fail(__FILE__, __LINE__, "event number", (uint16_t)expected, number);
+		expected++;
+	}
+
+	pthread_join(producer, NULL);
+	CHECK(!event_pending(&queue));
+	CHECK(!event_get(&queue, &event));
+}
+
+TEST(event_queue_full_drops) {
+	event_t event;
+	uint8_t i;
+
+	for(i=0;i<EVENT_QUEUE_SIZE;i++)
+		CHECK(event_put(&queue, EVENT_KEY_DOWN, i));
+	CHECK(!event_put(&queue, EVENT_KEY_DOWN, i));
+	CHECK_EQ(1, queue.dropped);
+	CHECK_EQ(EVENT_QUEUE_SIZE, event_count(&queue));
+
+	for(i=0;i<EVENT_QUEUE_SIZE;i++) {
+		CHECK(event_get(&queue, &event));
+		CHECK_EQ(i, event.data);
+	}
+	CHECK(!event_get(&queue, &event));
+}
@@ -0,0 +1,116 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "../test.h"
+#include "../device.h"
+
+#include "Driver/keys.h"
+
+// scans until the key changes, returns the number of scans, 0 if it does not
+static uint8_t keys_settle(event_queue_t *events, uint8_t key, uint8_t type) {
+	event_t event;
+	uint8_t scans;
+
+	for(scans=1;scans<=8;scans++) {
+		keys_scan();
+		if(event_get(events, &event)) {
+			CHECK_EQ(type, event.type);
+			CHECK_EQ(key, event.data);
+			return scans;
+		}
+	}
+	return 0;
+}
+
+TEST(keys_every_key_debounced_in_four_scans) {
+	event_queue_t events = {0};
+	uint8_t key;
+
+	keys_init(&events);
+
+	// keys on both rows take the same four ticks
+	for(key=0;key<BUTTONS_ROWS*BUTTONS_COLUMNS;key++) {
+		mock_keys_set(BUTTONS_BUTTON1 << key);
+		CHECK_EQ(4, keys_settle(&events, key, EVENT_KEY_DOWN));
+		CHECK_EQ(BUTTONS_BUTTON1 << key, keys_state());
+
+		mock_keys_set(0);
+		CHECK_EQ(4, keys_settle(&events, key, EVENT_KEY_UP));
+		CHECK_EQ(0, keys_state());
+	}
+}
+
+TEST(keys_bounce_ignored) {
+	event_queue_t events = {0};
+	uint8_t i;
+
+	keys_init(&events);
+
+	for(i=0;i<8;i++) {
+		mock_keys_set((i & 1) ? 0 : BUTTONS_BUTTON1 << 5);
+		keys_scan();
+	}
+	CHECK(!event_pending(&events));
+	CHECK_EQ(0, keys_state());
+}
+
+TEST(keys_rows_released_between_scans) {
+	event_queue_t events = {0};
+
+	keys_init(&events);
+	keys_scan();
+
+	// no row is left driving the matrix
+	CHECK_EQ(0, BOARD_DDRREG(PIN_KEY_ROW1_PORT) & (PIN_KEY_ROW1_MASK | PIN_KEY_ROW2_MASK));
+}
+
+TEST(keys_jtag_disabled_at_startup) {
+	device_boot();
+
+	CHECK(MCUCR & _BV(JTD));
+}
+
+// the key is timed from its first edge, four scans before it is reported
+TEST(keys_latency_includes_debounce) {
+	FeatureReport_t report = { .Page = FEATURE_PAGE_LATENCY };
+	RadioState_t state = {0};
+	uint8_t ms;
+
+	device_boot();
+	device_connect();
+	CHECK(device_feature_set(&report));
+
+	mock_keys_set(BUTTONS_BUTTON1);
+	for(ms=0;ms<10 && !(state.Keys & BUTTONS_BUTTON1);ms++) {
+		device_tick(1);
+		while(device_state(&state) && !(state.Keys & BUTTONS_BUTTON1))
+			;
+	}
+	CHECK(state.Keys & BUTTONS_BUTTON1);
+
+	CHECK(device_feature_get(FEATURE_PAGE_LATENCY, &report));
+	CHECK_EQ(1, report.Latency.count);
+	CHECK(report.Latency.min >= 3 * 1000000UL / SCHED_TIMESTAMP_NS);
+}
@@ -0,0 +1,173 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../test.h"
+#include "../device.h"
+
+#include "Driver/preset.h"
+#include "Driver/pt6524.h"
+
+#define PT_BLOCK_BYTES		9	// address and eight bytes of data
+
+static const uint8_t name_a[] = { 0, 5, 'A', 'l', 'p', 'h', 'a' };
+static const uint8_t name_b[] = { 0, 4, 'B', 'r', 'a', 'v', 'o' };
+
+// boots with the Dataflash found and its index read
+static void preset_boot(void) {
+	device_boot();
+	device_tick(2 * PRESET_TASK_PERIOD_MS);
+}
+
+// lets the record and index page programs finish
+static void preset_settle(void) {
+	uint16_t ms = 0;
+
+	while(preset_busy() && ms++ < 100)
+		device_tick(1);
+	CHECK(!preset_busy());
+}
+
+static void preset_store(uint8_t preset, const uint8_t *record, uint8_t length) {
+	CHECK(preset_write(preset, 0, record, length));
+	CHECK(preset_commit(preset));
+	preset_settle();
+}
+
+// reads the start of a record, loading it into the cache first
+static void preset_fetch(uint8_t preset, uint8_t *record, uint8_t length) {
+	if(!preset_read(preset, 0, record, length))
+		device_tick(PRESET_TASK_PERIOD_MS);
+	CHECK(preset_read(preset, 0, record, length));
+}
+
+TEST(preset_upload_times_out) {
+	uint8_t record[sizeof(name_a)];
+
+	preset_boot();
+	CHECK(preset_write(1, 0, name_a, sizeof(name_a)));
+	device_tick(PRESET_UPLOAD_TIMEOUT_MS / 2);
+	CHECK(preset_write(1, 0, name_a, sizeof(name_a)));
+
+	// each write restarts the timeout, and the upload holds the cache until it runs out
+	device_tick(PRESET_UPLOAD_TIMEOUT_MS - 1);
+	CHECK(!preset_read(2, 0, record, sizeof(record)));
+	device_tick(PRESET_TASK_PERIOD_MS);
+	CHECK(!preset_commit(1));
+	preset_fetch(2, record, sizeof(record));
+	CHECK_EQ(0xFF, record[PRESET_NAME_LENGTH]);
+}
+
+TEST(preset_upload_dropped_on_configure) {
+	preset_boot();
+	device_connect();
+	CHECK(preset_write(3, 0, name_a, sizeof(name_a)));
+
+	mock_usb_configure();
+	device_run();
+	CHECK(!preset_commit(3));
+}
+
+TEST(preset_upload_replaced_by_another) {
+	uint8_t record[sizeof(name_b)];
+
+	preset_boot();
+	CHECK(preset_write(3, 0, name_a, sizeof(name_a)));
+	CHECK(preset_write(4, 0, name_b, sizeof(name_b)));
+	CHECK(!preset_commit(3));
+	CHECK(preset_commit(4));
+	preset_settle();
+
+	preset_fetch(4, record, sizeof(record));
+	CHECK(memcmp(name_b, record, sizeof(record)) == 0);
+	preset_fetch(3, record, sizeof(record));
+	CHECK_EQ(0xFF, record[PRESET_NAME_LENGTH]);
+}
+
+// the index pages are written in turn and the newest intact one is used after a reset
+TEST(preset_index_survives_power_loss) {
+	uint8_t (*flash)[MOCK_FLASH_PAGE];
+	uint8_t record[sizeof(name_a)];
+	int status;
+
+	flash = mmap(NULL, sizeof(mock_flash), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	CHECK(flash != MAP_FAILED);
+
+	// the first power-on stores a preset, and loses power while it stores it again
+	if(fork() == 0) {
+		preset_boot();
+		preset_store(7, name_a, sizeof(name_a));
+		preset_store(7, name_b, sizeof(name_b));
+		preset_store(7, name_a, sizeof(name_a));
+		CHECK_EQ(6, mock_flash_programs());
+
+		mock_flash_fail_after(1);
+		CHECK(preset_write(7, 0, name_b, sizeof(name_b)));
+		CHECK(preset_commit(7));
+		device_tick(100);
+		CHECK_EQ(8, mock_flash_programs());
+		memcpy(flash, mock_flash, sizeof(mock_flash));
+		_exit(0);
+	}
+	wait(&status);
+	CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	// the next one finds the record the last intact index points to
+	memcpy(mock_flash, flash, sizeof(mock_flash));
+	preset_boot();
+	preset_fetch(7, record, sizeof(record));
+	CHECK(memcmp(name_a, record, sizeof(record)) == 0);
+
+	// and writes on from there
+	preset_store(7, name_b, sizeof(name_b));
+	preset_fetch(7, record, sizeof(record));
+	CHECK(memcmp(name_b, record, sizeof(record)) == 0);
+}
+
+// the Dataflash transfers end with SPIF set, which must not start a display transfer
+TEST(preset_store_then_display_commit) {
+	size_t start;
+	size_t i;
+
+	preset_boot();
+	start = mock_spi_log.count;
+	preset_store(5, name_a, sizeof(name_a));
+	CHECK_EQ(start, mock_spi_log.count);
+
+	// the next display update goes out as whole blocks
+	pt6524_set_digit(0, 0x0F);
+	device_tick(PRESET_TASK_PERIOD_MS);
+	CHECK(mock_spi_log.count > start);
+	CHECK_EQ(0, (mock_spi_log.count - start) % PT_BLOCK_BYTES);
+	for(i=start;i<mock_spi_log.count;i+=PT_BLOCK_BYTES) {
+		CHECK_EQ(0x82, mock_spi_log.data[i]);
+		CHECK(!mock_spi_log.ce[i]);
+	}
+	CHECK(!pt6524_busy());
+}
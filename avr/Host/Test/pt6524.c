@@ -0,0 +1,223 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include <string.h>
+
+#include "../test.h"
+
+#include <avr/interrupt.h>
+
+#include "Driver/pt6524.h"
+
+#define PT_BLOCK_BYTES		9	// address and eight bytes of data
+
+static uint8_t callbacks;
+
+static void pt6524_done(void) {
+	callbacks++;
+}
+
+// clocks out the queued blocks as the SPI hardware would, returns the bytes sent
+static size_t pt6524_drain(void) {
+	size_t start = mock_spi_log.count;
+
+	while(pt6524_busy()) {
+		mock_spi_shift();
+		SPI_STC_vect();
+	}
+	return mock_spi_log.count - start;
+}
+
+// checks the CE framing of a block: low for the address, high for the data
+static void pt6524_check_block(size_t start, uint8_t dd) {
+	size_t i;
+
+	CHECK_EQ(0x82, mock_spi_log.data[start]);
+	CHECK(!mock_spi_log.ce[start]);
+	for(i=1;i<PT_BLOCK_BYTES;i++)
+		CHECK(mock_spi_log.ce[start + i]);
+	CHECK_EQ(dd, mock_spi_log.data[start + PT_BLOCK_BYTES - 1] & 0x03);
+}
+
+TEST(pt6524_commit_returns_before_transfer) {
+	pt6524_init();
+
+	// the first block is started with its address byte, nothing has been clocked out
+	CHECK(pt6524_busy());
+	CHECK_EQ(0, mock_spi_log.count);
+	CHECK(SPCR & _BV(SPIE));
+
+	CHECK_EQ(PT_BLOCKS * PT_BLOCK_BYTES, pt6524_drain());
+	CHECK(!pt6524_busy());
+	CHECK(!(PORT_PT & _BV(PORT_PTS)));
+}
+
+TEST(pt6524_blocks_framed_by_ce) {
+	uint8_t i;
+
+	pt6524_init();
+	pt6524_drain();
+
+	for(i=0;i<PT_BLOCKS;i++)
+		pt6524_check_block(i * PT_BLOCK_BYTES, i);
+}
+
+TEST(pt6524_only_changed_blocks_sent) {
+	size_t start;
+
+	pt6524_init();
+	pt6524_drain();
+
+	// nothing changed, nothing sent
+	CHECK(!pt6524_commit());
+
+	// set and reset before the commit is no change either
+	pt6524_set_digit(20, 0x0F);
+	pt6524_set_digit(20, 0x00);
+	CHECK(!pt6524_commit());
+
+	start = mock_spi_log.count;
+	pt6524_set_digit(20, 0x0F);
+	CHECK(pt6524_commit());
+	CHECK_EQ(PT_BLOCK_BYTES, pt6524_drain());
+	pt6524_check_block(start, 20 / PT_DIGITS_PER_BLOCK);
+}
+
+TEST(pt6524_changes_held_during_transfer) {
+	pt6524_init();
+
+	pt6524_set_digit(0, 0x01);
+	CHECK(!pt6524_commit());
+	CHECK_EQ(PT_BLOCKS * PT_BLOCK_BYTES, pt6524_drain());
+
+	CHECK(pt6524_pending());
+	CHECK(pt6524_commit());
+	CHECK_EQ(PT_BLOCK_BYTES, pt6524_drain());
+}
+
+TEST(pt6524_callback_after_last_block) {
+	pt6524_init();
+	pt6524_set_callback(pt6524_done);
+
+	while(pt6524_busy()) {
+		CHECK_EQ(0, callbacks);
+		mock_spi_shift();
+		SPI_STC_vect();
+	}
+	CHECK_EQ(1, callbacks);
+}
+
+TEST(pt6524_bus_lent_between_transfers) {
+	pt6524_init();
+
+	CHECK(!pt6524_bus_acquire());
+	pt6524_drain();
+
+	CHECK(pt6524_bus_acquire());
+	CHECK(!(SPCR & _BV(SPIE)));
+
+	// the borrower's transfers leave the display alone
+	pt6524_set_digit(0, 0x01);
+	CHECK(!pt6524_commit());
+	CHECK(!pt6524_busy());
+
+	pt6524_bus_release();
+	CHECK(SPCR & _BV(SPIE));
+	CHECK(pt6524_commit());
+	CHECK_EQ(PT_BLOCK_BYTES, pt6524_drain());
+}
+
+// Golden vectors from the datasheet's "SERIAL DATA INPUT" and "DISPLAY DATA AND THE
+// OUTPUT PIN CORRESPONDENCE": the address 41H sent LSB first, then D1..D52 of the block,
+// CU P0 P1 P2 P3 DR SC BU, two zero bits and DD. SGn drives D4n-3..D4n on COM1..COM4.
+typedef struct {
+	const char *name;
+	uint8_t digit;			// segment output from zero, or 0xFF
+	uint8_t coms;			// COM1..COM4 in bits 0..3
+	int16_t segment;		// display data bit from zero, or -1
+	bool off;
+	uint8_t wire[PT_BLOCK_BYTES];
+} pt6524_golden_t;
+
+static const pt6524_golden_t pt6524_golden[] = {
+	{ "SG1 COM1 = D1",   0,  0x01, -1,  false, { 0x82, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40 } },
+	{ "SG1 COM4 = D4",   0,  0x08, -1,  false, { 0x82, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40 } },
+	{ "SG2 = D5..D8",    1,  0x0F, -1,  false, { 0x82, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40 } },
+	{ "SG12 COM2 = D46", 11, 0x02, -1,  false, { 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x40 } },
+	{ "SG13 = D49..D52", 12, 0x0F, -1,  false, { 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x40 } },
+	{ "SG14 COM1 = D53", 13, 0x01, -1,  false, { 0x82, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 } },
+	{ "SG27 COM3 = D107", 26, 0x04, -1, false, { 0x82, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 } },
+	{ "SG51 COM4 = D204", 50, 0x08, -1, false, { 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x03 } },
+	{ "D204",            0xFF, 0,   203, false, { 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x03 } },
+	{ "D105",            0xFF, 0,   104, false, { 0x82, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 } },
+	{ "SC display off",  0xFF, 0,   -1,  true,  { 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60 } },
+};
+
+TEST(pt6524_power_on_frame) {
+	static const uint8_t wire[PT_BLOCKS][PT_BLOCK_BYTES] = {
+		{ 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40 },	// DR, 1/2 bias
+		{ 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 },
+		{ 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 },
+		{ 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 },
+	};
+
+	pt6524_init();
+	CHECK_EQ(sizeof(wire), pt6524_drain());
+	CHECK(memcmp(wire, mock_spi_log.data, sizeof(wire)) == 0);
+}
+
+TEST(pt6524_golden_vectors) {
+	const pt6524_golden_t *golden;
+	size_t start;
+	size_t i;
+	size_t j;
+
+	pt6524_init();
+	pt6524_drain();
+
+	for(i=0;i<sizeof(pt6524_golden)/sizeof(pt6524_golden[0]);i++) {
+		golden = &pt6524_golden[i];
+
+		if(golden->digit != 0xFF)
+			pt6524_set_digit(golden->digit, golden->coms);
+		if(golden->segment >= 0)
+			pt6524_set_segment(golden->segment, true);
+		pt6524_set_display(!golden->off);
+
+		start = mock_spi_log.count;
+		CHECK(pt6524_commit());
+		CHECK_EQ(PT_BLOCK_BYTES, pt6524_drain());
+		for(j=0;j<PT_BLOCK_BYTES;j++) {
+			if(mock_spi_log.data[start + j] != golden->wire[j])
+				test_fail(__FILE__, __LINE__, golden->name, golden->wire[j], mock_spi_log.data[start + j]);
+		}
+
+		// back to the power-on frame for the next vector
+		pt6524_clear();
+		pt6524_set_display(true);
+		pt6524_commit();
+		pt6524_drain();
+	}
+}
@@ -0,0 +1,102 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "../test.h"
+#include "../device.h"
+
+#define PACKETS_PER_REPORT	((sizeof(RadioState_t) + GENERIC_EPSIZE - 1) / GENERIC_EPSIZE)
+
+// runs the device for a second as the host does, polling the IN endpoint at the
+// endpoint's interval, and returns the IN packets sent meanwhile
+static uint32_t report_poll_second(uint8_t *sequence, uint32_t *reports) {
+	mock_usb_stats_t before;
+	mock_usb_stats_t after;
+	uint8_t packet[GENERIC_EPSIZE];
+	uint16_t offset = 0;
+	uint16_t ms;
+	int length;
+
+	mock_usb_get_stats(GENERIC_IN_EPADDR, &before);
+	for(ms=0;ms<1000;ms++) {
+		// the start of frame is the device's tick
+		mock_usb_sof();
+		device_run();
+		if(ms % GENERIC_POLLING_MS)
+			continue;
+
+		length = mock_usb_in(GENERIC_IN_EPADDR, packet);
+		if(length < 0)
+			continue;
+
+		// the sequence number is the last byte, and counts each report once
+		offset += length;
+		if(offset == sizeof(RadioState_t)) {
+			CHECK_EQ((uint8_t)(*sequence + 1), packet[length - 1]);
+			*sequence = packet[length - 1];
+			(*reports)++;
+			offset = 0;
+		}
+	}
+	mock_usb_get_stats(GENERIC_IN_EPADDR, &after);
+	CHECK_EQ(0, offset);
+	return after.in_packets - before.in_packets;
+}
+
+// connects with the presets found, and takes the reports sent so far
+static void report_connect(RadioState_t *state) {
+	device_boot();
+	mock_usb_configure();
+	device_tick(2 * PRESET_TASK_PERIOD_MS);
+
+	CHECK(device_state(state));
+	while(device_state(state))
+		;
+}
+
+TEST(report_idle_host_only_naked) {
+	RadioState_t state;
+	uint32_t reports = 0;
+
+	report_connect(&state);
+
+	CHECK_EQ(0, report_poll_second(&state.Sequence, &reports));
+	CHECK_EQ(0, reports);
+}
+
+TEST(report_sent_once_per_change) {
+	const uint8_t commands[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x01 };
+	RadioState_t state;
+	uint32_t reports = 0;
+	uint8_t i;
+
+	report_connect(&state);
+
+	// every change is one whole report, numbered in turn
+	for(i=0;i<5;i++) {
+		CHECK(device_command(commands, sizeof(commands)));
+		CHECK_EQ(PACKETS_PER_REPORT, report_poll_second(&state.Sequence, &reports));
+	}
+	CHECK_EQ(5, reports);
+}
@@ -0,0 +1,125 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "../test.h"
+#include "../device.h"
+
+#include "Driver/scheduler.h"
+
+static uint32_t runs;
+
+static void task_quick(void) {
+	runs++;
+}
+
+// takes a few emulated Timer 1 cycles
+static void task_slow(void) {
+	uint16_t start = sched_cycles();
+
+	while((uint16_t)(sched_cycles() - start) < 100)
+		;
+}
+
+TEST(scheduler_runs_due_tasks) {
+	sched_init();
+	sched_add(task_quick, 2, 0, 1000);
+
+	TIMER0_COMPA_vect();
+	sched_run();
+	CHECK_EQ(0, runs);
+
+	TIMER0_COMPA_vect();
+	sched_run();
+	CHECK_EQ(1, runs);
+
+	// missed periods only run the task once
+	TIMER0_COMPA_vect();
+	TIMER0_COMPA_vect();
+	TIMER0_COMPA_vect();
+	TIMER0_COMPA_vect();
+	sched_run();
+	CHECK_EQ(2, runs);
+}
+
+TEST(scheduler_stats_by_task_id) {
+	sched_stats_t stats;
+	uint8_t quick;
+	uint8_t slow;
+
+	sched_init();
+	slow = sched_add(task_slow, 1, 1, 10);
+	quick = sched_add(task_quick, 1, 0, 1000);
+
+	TIMER0_COMPA_vect();
+	sched_run();
+
+	sched_get_stats(&stats);
+	CHECK(stats.wcet[slow] >= 100);
+	CHECK_EQ(1, stats.overruns[slow]);
+	CHECK_EQ(0, stats.overruns[quick]);
+	CHECK_EQ(_BV(slow), stats.overrun_flags);
+	CHECK_EQ(0, stats.sof_locked);
+
+	// the flags are cleared by reading, the counts are kept
+	sched_get_stats(&stats);
+	CHECK_EQ(0, stats.overrun_flags);
+	CHECK_EQ(1, stats.overruns[slow]);
+
+	sched_reset_stats();
+	sched_get_stats(&stats);
+	CHECK_EQ(0, stats.wcet[slow]);
+	CHECK_EQ(0, stats.overruns[slow]);
+}
+
+TEST(scheduler_sof_lock) {
+	sched_stats_t stats;
+
+	sched_init();
+
+	sched_sof();
+	sched_get_stats(&stats);
+	CHECK_EQ(1, stats.sof_locked);
+
+	// the timer runs out when a frame is missing
+	TIMER0_COMPA_vect();
+	sched_get_stats(&stats);
+	CHECK_EQ(0, stats.sof_locked);
+}
+
+TEST(scheduler_feature_page) {
+	FeatureReport_t report;
+
+	device_boot();
+	device_connect();
+	mock_usb_sof();
+	device_run();
+
+	CHECK(device_feature_get(FEATURE_PAGE_CAPABILITIES, &report));
+	CHECK(report.Capabilities.Capabilities & CAPABILITY_SCHEDULER);
+
+	CHECK(device_feature_get(FEATURE_PAGE_SCHEDULER, &report));
+	CHECK_EQ(FEATURE_PAGE_SCHEDULER, report.Page);
+	CHECK_EQ(1, report.Scheduler.sof_locked);
+}
@@ -0,0 +1,254 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "../test.h"
+#include "../device.h"
+
+TEST(usb_state_report_after_configure) {
+	RadioState_t state;
+
+	device_boot();
+	mock_usb_configure();
+	device_run();
+
+	CHECK(device_state(&state));
+	CHECK_EQ(1, state.Sequence);
+	// nothing has changed since
+	CHECK(!device_state(&state));
+}
+
+TEST(usb_command_on_interrupt_endpoint) {
+	const uint8_t commands[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x02 };
+	RadioState_t state;
+
+	device_boot();
+	device_connect();
+
+	CHECK(device_command(commands, sizeof(commands)));
+	CHECK(device_state(&state));
+	CHECK_EQ(0, state.LEDs[0]);
+	CHECK_EQ(1, state.LEDs[1]);
+	CHECK_EQ(1, state.CommandSequence);
+	CHECK_EQ(0, state.CommandErrors);
+}
+
+TEST(usb_command_through_set_report) {
+	const uint8_t commands[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x01 };
+	RadioState_t state;
+
+	device_boot();
+	device_connect();
+
+	CHECK(device_command_control(commands, sizeof(commands)));
+	CHECK(device_state(&state));
+	CHECK_EQ(1, state.LEDs[0]);
+	CHECK_EQ(0, state.LEDs[1]);
+	CHECK_EQ(1, state.CommandSequence);
+}
+
+TEST(usb_capabilities_page) {
+	FeatureReport_t report;
+
+	device_boot();
+	device_connect();
+	// the preset store looks for the Dataflash on its first run, and reads the index on the next
+	device_tick(2 * PRESET_TASK_PERIOD_MS);
+
+	CHECK(device_feature_get(FEATURE_PAGE_CAPABILITIES, &report));
+	CHECK_EQ(FEATURE_PAGE_CAPABILITIES, report.Page);
+	CHECK_EQ(PROTOCOL_VERSION, report.Capabilities.ProtocolVersion);
+	CHECK_EQ(GENERIC_REPORT_SIZE, report.Capabilities.ReportSize);
+	CHECK(report.Capabilities.Capabilities & CAPABILITY_PRESETS);
+}
+
+TEST(usb_unknown_request_is_stalled) {
+	USB_Request_Header_t request = {
+		.bmRequestType = REQDIR_DEVICETOHOST | REQTYPE_VENDOR | REQREC_DEVICE,
+		.bRequest = 0x42,
+	};
+
+	device_boot();
+	device_connect();
+
+	CHECK_EQ(-1, mock_usb_control(&request, 0));
+}
+
+TEST(usb_set_report_aborted_by_new_request) {
+	const uint8_t commands[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x01 };
+	RadioState_t state;
+
+	device_boot();
+	device_connect();
+
+	// the host sends one packet of the report, then starts over with a new request
+	mock_usb_abort_control(FIXED_CONTROL_ENDPOINT_SIZE, false);
+	CHECK(!device_command_control(commands, sizeof(commands)));
+
+	// the device has given up on the report and takes the next one
+	CHECK(device_command_control(commands, sizeof(commands)));
+	CHECK(device_state(&state));
+	CHECK_EQ(1, state.LEDs[0]);
+}
+
+TEST(usb_set_report_aborted_by_suspend) {
+	const uint8_t commands[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x01 };
+	RadioState_t state;
+
+	device_boot();
+	device_connect();
+
+	mock_usb_abort_control(FIXED_CONTROL_ENDPOINT_SIZE, true);
+	CHECK(!device_command_control(commands, sizeof(commands)));
+	CHECK_EQ(DEVICE_STATE_Suspended, USB_DeviceState);
+
+	mock_usb_resume();
+	CHECK(device_command_control(commands, sizeof(commands)));
+	CHECK(device_state(&state));
+	CHECK_EQ(1, state.LEDs[0]);
+}
+
+TEST(usb_sequence_restarts_on_configure) {
+	const uint8_t commands[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x01 };
+	uint8_t report[GENERIC_REPORT_SIZE];
+	RadioState_t state;
+	uint8_t offset;
+	uint8_t i;
+
+	device_boot();
+
+	// two hosts in turn, both counting from one
+	for(i=0;i<2;i++) {
+		device_connect();
+		device_report(report, 1, commands, sizeof(commands));
+		for(offset=0;offset<GENERIC_REPORT_SIZE;offset+=GENERIC_EPSIZE)
+			CHECK(mock_usb_out(GENERIC_OUT_EPADDR, &report[offset], MIN(GENERIC_EPSIZE, GENERIC_REPORT_SIZE - offset)));
+		device_run();
+
+		CHECK(device_state(&state));
+		CHECK_EQ(1, state.CommandSequence);
+		CHECK_EQ(0, state.CommandErrors);
+	}
+}
+
+// sends a whole report on the interrupt OUT endpoint, without letting the main loop run
+static void usb_send_report(uint8_t sequence, const uint8_t *commands, uint8_t length) {
+	uint8_t report[GENERIC_REPORT_SIZE];
+	uint8_t offset;
+
+	device_report(report, sequence, commands, length);
+	for(offset=0;offset<GENERIC_REPORT_SIZE;offset+=GENERIC_EPSIZE)
+		CHECK(mock_usb_out(GENERIC_OUT_EPADDR, &report[offset], MIN(GENERIC_EPSIZE, GENERIC_REPORT_SIZE - offset)));
+}
+
+TEST(usb_commands_run_from_main_loop) {
+	const uint8_t commands[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x02 };
+	RadioState_t state;
+
+	device_boot();
+	device_connect();
+
+	// the interrupt only queues the report, nothing changes until the main loop runs it
+	usb_send_report(1, commands, sizeof(commands));
+	CHECK(!device_state(&state));
+
+	device_run();
+	CHECK(device_state(&state));
+	CHECK_EQ(1, state.LEDs[1]);
+	CHECK_EQ(1, state.CommandSequence);
+}
+
+TEST(usb_commands_dropped_when_queue_full) {
+	const uint8_t interrupt[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x02 };
+	const uint8_t control[] = { PROTOCOL_CMD_SET_LEDS, 1, 0x01 };
+	RadioState_t state;
+	uint8_t i;
+
+	device_boot();
+	device_connect();
+
+	// the slot of the report being run is kept free, so only the first ones can wait
+	for(i=0;i<COMMAND_REPORTS+1;i++)
+		usb_send_report(0x80 + i, interrupt, sizeof(interrupt));
+	CHECK(device_state(&state));
+	while(device_state(&state))
+		;
+	CHECK_EQ(2, state.CommandsDropped);
+
+	// SET_REPORT requests have their own buffer and slots
+	CHECK(device_command_control(control, sizeof(control)));
+	while(device_state(&state))
+		;
+	CHECK_EQ(1, state.LEDs[0]);
+	CHECK_EQ(0, state.LEDs[1]);
+	CHECK_EQ(0, state.CommandErrors);
+	CHECK_EQ(2, state.CommandsDropped);
+}
+
+TEST(usb_feature_page_applied_from_main_loop) {
+	USB_Request_Header_t request = {
+		.bmRequestType = REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE,
+		.bRequest = HID_REQ_SetReport,
+		.wValue = (HID_REPORT_ITEM_Feature + 1) << 8,
+		.wIndex = INTERFACE_ID_GenericHID,
+		.wLength = sizeof(FeatureReport_t),
+	};
+	FeatureReport_t report;
+	gesture_config_t config;
+
+	device_boot();
+	device_connect();
+	CHECK(device_feature_get(FEATURE_PAGE_GESTURES, &report));
+	report.Gestures.long_ms = 777;
+
+	// the interrupt only takes the page, and stalls the next one until it has been applied
+	CHECK_EQ(sizeof(report), mock_usb_control(&request, &report));
+	CHECK_EQ(-1, mock_usb_control(&request, &report));
+	gesture_get_config(&config);
+	CHECK(config.long_ms != 777);
+
+	device_run();
+	gesture_get_config(&config);
+	CHECK_EQ(777, config.long_ms);
+
+	memset(&report, 0, sizeof(report));
+	CHECK(device_feature_get(FEATURE_PAGE_GESTURES, &report));
+	CHECK_EQ(FEATURE_PAGE_GESTURES, report.Page);
+	CHECK_EQ(777, report.Gestures.long_ms);
+}
+
+TEST(usb_marquee_for_unknown_field_rejected) {
+	const uint8_t commands[] = { PROTOCOL_CMD_MARQUEE, 6, DISPLAY_FIELDS, 0, 1, 0, MARQUEE_WRAP, 'X' };
+	RadioState_t state;
+
+	device_boot();
+	device_connect();
+
+	CHECK(device_command(commands, sizeof(commands)));
+	while(device_state(&state))
+		;
+	CHECK_EQ(1, state.CommandSequence);
+	CHECK_EQ(1, state.CommandErrors);
+	device_tick(10);
+}
@@ -0,0 +1,196 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Dumps the input latency statistics of the feature report through hidraw, to compare
+// firmware builds. Without a device path the first hidraw node of the generic HID
+// interface is used.
+//
+//   latency [-r] [-l max_us] [/dev/hidrawN]
+//
+//   -r         clears the statistics after they have been read
+//   -l max_us  exits with 3 if the worst latency is above max_us
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/hidraw.h>
+
+#include "WebRadio.h"
+
+#define HID_ID			"HID_ID=0003:000003EB:0000204F"
+#define HID_INTERFACE	"/input0"		// INTERFACE_ID_GenericHID
+#define BAR_WIDTH		50
+
+// finds the hidraw node of the generic HID interface from the uevent of each node
+static bool find_device(char *path, size_t size) {
+	char line[256];
+	bool id;
+	bool interface;
+	glob_t nodes;
+	FILE *file;
+	size_t i;
+
+	if(glob("/sys/class/hidraw/hidraw*/device/uevent", 0, NULL, &nodes))
+		return false;
+
+	for(i=0;i<nodes.gl_pathc;i++) {
+		file = fopen(nodes.gl_pathv[i], "r");
+		if(!file)
+			continue;
+
+		id = interface = false;
+		while(fgets(line, sizeof(line), file)) {
+			line[strcspn(line, "\n")] = 0;
+			if(!strcmp(line, HID_ID))
+				id = true;
+			if(!strncmp(line, "HID_PHYS=", 9) && strstr(line, HID_INTERFACE))
+				interface = true;
+		}
+		fclose(file);
+
+		if(id && interface) {
+			// /sys/class/hidraw/hidrawN/device/uevent -> /dev/hidrawN
+			snprintf(path, size, "/dev/%.*s", (int)strcspn(nodes.gl_pathv[i] + 18, "/"), nodes.gl_pathv[i] + 18);
+			globfree(&nodes);
+			return true;
+		}
+	}
+	globfree(&nodes);
+	return false;
+}
+
+// Feature reports go through hidraw with the report number first, zero as the device
+// has no numbered reports. A report shorter than the page only selects it.
+static bool feature_set(int fd, const FeatureReport_t *report, size_t length) {
+	uint8_t buffer[1 + sizeof(FeatureReport_t)];
+
+	buffer[0] = 0;
+	memcpy(&buffer[1], report, length);
+	return ioctl(fd, HIDIOCSFEATURE(1 + length), buffer) >= 0;
+}
+
+static bool feature_get(int fd, FeatureReport_t *report) {
+	uint8_t buffer[1 + sizeof(FeatureReport_t)];
+
+	buffer[0] = 0;
+	if(ioctl(fd, HIDIOCGFEATURE(sizeof(buffer)), buffer) < (int)sizeof(buffer))
+		return false;
+	memcpy(report, &buffer[1], sizeof(FeatureReport_t));
+	return true;
+}
+
+static double to_us(uint32_t ticks) {
+	return ticks * (double)SCHED_TIMESTAMP_NS / 1000.0;
+}
+
+static void print_stats(const latency_stats_t *stats) {
+	uint16_t most = 1;
+	int bar;
+	int i;
+
+	printf("reports  %u\n", stats->count);
+	if(!stats->count)
+		return;
+	printf("min      %8.0f us\n", to_us(stats->min));
+	printf("avg      %8.0f us\n", to_us(stats->avg));
+	printf("max      %8.0f us\n", to_us(stats->max));
+	printf("\n");
+
+	for(i=0;i<LATENCY_BINS;i++) {
+		if(stats->histogram[i] > most)
+			most = stats->histogram[i];
+	}
+
+	// bin n counts latencies from 2^n up to 2^(n+1) - 1 ticks, bin 0 also counts zero
+	for(i=0;i<LATENCY_BINS;i++) {
+		bar = (stats->histogram[i] * BAR_WIDTH + most - 1) / most;
+		printf("%8.0f .. %8.0f us %6u %.*s\n", i ? to_us(1u << i) : 0.0, to_us((2u << i) - 1),
+		       stats->histogram[i], bar, "##################################################");
+	}
+}
+
+int main(int argc, char **argv) {
+	FeatureReport_t report;
+	char path[64];
+	bool reset = false;
+	long limit = -1;
+	int option;
+	int fd;
+
+	while((option = getopt(argc, argv, "rl:")) != -1) {
+		switch(option) {
+		case 'r':
+			reset = true;
+			break;
+		case 'l':
+			limit = strtol(optarg, NULL, 10);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-r] [-l max_us] [/dev/hidrawN]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if(optind < argc) {
+		snprintf(path, sizeof(path), "%s", argv[optind]);
+	} else if(!find_device(path, sizeof(path))) {
+		fprintf(stderr, "no web radio found\n");
+		return 1;
+	}
+
+	fd = open(path, O_RDWR);
+	if(fd < 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	memset(&report, 0, sizeof(report));
+	report.Page = FEATURE_PAGE_LATENCY;
+	if(!feature_set(fd, &report, 1) || !feature_get(fd, &report) || report.Page != FEATURE_PAGE_LATENCY) {
+		fprintf(stderr, "%s: the latency page cannot be read\n", path);
+		close(fd);
+		return 1;
+	}
+	print_stats(&report.Latency);
+
+	// writing the whole page clears the statistics
+	if(reset && !feature_set(fd, &report, sizeof(report))) {
+		fprintf(stderr, "%s: the latency page cannot be cleared\n", path);
+		close(fd);
+		return 1;
+	}
+	close(fd);
+
+	if(limit >= 0 && report.Latency.count && to_us(report.Latency.max) > limit) {
+		fprintf(stderr, "worst latency %.0f us is above %ld us\n", to_us(report.Latency.max), limit);
+		return 3;
+	}
+	return 0;
+}
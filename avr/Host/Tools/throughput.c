@@ -0,0 +1,188 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Measures the display stream throughput with bulk transfers through usbdevfs, for
+// firmware built with DISPLAY_STREAM=yes. Each packet rewrites the whole panel with
+// the next digit pattern, starting at output 0.
+//
+//   throughput [-s seconds] [-n packets_per_transfer] [/dev/bus/usb/BBB/DDD]
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/usbdevice_fs.h>
+
+#include "Descriptors.h"
+#include "Driver/pt6524.h"
+
+#define USB_VID			0x03EB
+#define USB_PID			0x204F
+#define TRANSFER_TIMEOUT_MS	1000
+#define MAX_PACKETS		64
+
+static unsigned read_sysfs(const char *device, const char *name, int base) {
+	char path[256];
+	char value[16];
+	FILE *file;
+
+	snprintf(path, sizeof(path), "%s/%s", device, name);
+	file = fopen(path, "r");
+	if(!file)
+		return 0;
+	if(!fgets(value, sizeof(value), file))
+		value[0] = 0;
+	fclose(file);
+	return strtoul(value, NULL, base);
+}
+
+// finds the usbdevfs node of the first web radio on the bus
+static bool find_device(char *path, size_t size) {
+	glob_t devices;
+	size_t i;
+
+	if(glob("/sys/bus/usb/devices/*/idVendor", 0, NULL, &devices))
+		return false;
+
+	for(i=0;i<devices.gl_pathc;i++) {
+		*strrchr(devices.gl_pathv[i], '/') = 0;
+		if(read_sysfs(devices.gl_pathv[i], "idVendor", 16) == USB_VID &&
+		   read_sysfs(devices.gl_pathv[i], "idProduct", 16) == USB_PID) {
+			snprintf(path, size, "/dev/bus/usb/%03u/%03u", read_sysfs(devices.gl_pathv[i], "busnum", 10),
+			         read_sysfs(devices.gl_pathv[i], "devnum", 10));
+			globfree(&devices);
+			return true;
+		}
+	}
+	globfree(&devices);
+	return false;
+}
+
+// fills each packet with the first output followed by two 4-bit outputs per byte
+static void fill_packets(uint8_t *buffer, int packets, unsigned *pattern) {
+	int i;
+	int n;
+
+	for(i=0;i<packets;i++) {
+		uint8_t digits = *pattern & 0x0F;
+
+		buffer[i * STREAM_EPSIZE] = 0;
+		for(n=1;n<STREAM_EPSIZE;n++)
+			buffer[i * STREAM_EPSIZE + n] = n <= (PT_DIGITS + 1) / 2 ? digits | (digits << 4) : 0;
+		(*pattern)++;
+	}
+}
+
+static double now(void) {
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+	static uint8_t buffer[MAX_PACKETS * STREAM_EPSIZE];
+	struct usbdevfs_bulktransfer transfer;
+	unsigned interface = INTERFACE_ID_Stream;
+	unsigned pattern = 0;
+	unsigned long long bytes = 0;
+	unsigned long transfers = 0;
+	double seconds = 5;
+	double start;
+	double elapsed;
+	int packets = 16;
+	char path[64];
+	int option;
+	int fd;
+	int sent;
+
+	while((option = getopt(argc, argv, "s:n:")) != -1) {
+		switch(option) {
+		case 's':
+			seconds = strtod(optarg, NULL);
+			break;
+		case 'n':
+			packets = atoi(optarg);
+			break;
+		default:
+			packets = 0;
+			break;
+		}
+	}
+	if(packets < 1 || packets > MAX_PACKETS || seconds <= 0) {
+		fprintf(stderr, "usage: %s [-s seconds] [-n 1..%d] [/dev/bus/usb/BBB/DDD]\n", argv[0], MAX_PACKETS);
+		return 2;
+	}
+
+	if(optind < argc) {
+		snprintf(path, sizeof(path), "%s", argv[optind]);
+	} else if(!find_device(path, sizeof(path))) {
+		fprintf(stderr, "no web radio found\n");
+		return 1;
+	}
+
+	fd = open(path, O_RDWR);
+	if(fd < 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	// the stream interface only exists in DISPLAY_STREAM builds
+	if(ioctl(fd, USBDEVFS_CLAIMINTERFACE, &interface) < 0) {
+		fprintf(stderr, "%s: interface %u cannot be claimed: %s\n", path, interface, strerror(errno));
+		close(fd);
+		return 1;
+	}
+
+	transfer.ep = STREAM_OUT_EPADDR;
+	transfer.len = packets * STREAM_EPSIZE;
+	transfer.timeout = TRANSFER_TIMEOUT_MS;
+	transfer.data = buffer;
+
+	start = now();
+	do {
+		fill_packets(buffer, packets, &pattern);
+		sent = ioctl(fd, USBDEVFS_BULK, &transfer);
+		if(sent < 0) {
+			fprintf(stderr, "%s: bulk transfer failed: %s\n", path, strerror(errno));
+			break;
+		}
+		bytes += sent;
+		transfers++;
+	} while(now() - start < seconds);
+	elapsed = now() - start;
+
+	ioctl(fd, USBDEVFS_RELEASEINTERFACE, &interface);
+	close(fd);
+
+	printf("%lu transfers of %d packets, %llu bytes in %.2f s\n", transfers, packets, bytes, elapsed);
+	printf("%.0f bytes/s, %.0f panel updates/s\n", bytes / elapsed, bytes / elapsed / STREAM_EPSIZE);
+	return sent < 0 ? 1 : 0;
+}
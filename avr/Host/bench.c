@@ -0,0 +1,162 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Runs the registered benchmarks and prints the time per iteration. Every run of a
+// benchmark is a child process on freshly reset mocks, so the firmware's static state
+// starts out as after a power-on reset each time. Arguments select the benchmarks whose
+// name contains one of them.
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define BENCHES			128
+#define BENCH_METRICS	4
+#define BENCH_MIN_NS	200000000ull	// shortest run which is reported
+#define BENCH_MAX		100000000ul		// iterations
+
+typedef struct {
+	const char *name;
+	bench_func_t func;
+} bench_t;
+
+static bench_t benches[BENCHES];
+static int bench_count;
+
+static uint64_t started;
+
+// written by the child process of a run, read by the parent
+typedef struct {
+	uint64_t elapsed;
+	struct {
+		const char *unit;
+		double value;
+		bool per_run;
+	} metrics[BENCH_METRICS];
+	int metric_count;
+} bench_result_t;
+
+static bench_result_t *result;
+
+void bench_register(const char *name, bench_func_t func) {
+	if(bench_count == BENCHES) {
+		fprintf(stderr, "too many benchmarks, raise BENCHES\n");
+		exit(2);
+	}
+	benches[bench_count].name = name;
+	benches[bench_count].func = func;
+	bench_count++;
+}
+
+void bench_start(void) {
+	result->metric_count = 0;
+	started = mock_ns();
+}
+
+void bench_stop(void) {
+	result->elapsed = mock_ns() - started;
+}
+
+void bench_metric(const char *unit, double value, bool per_run) {
+	if(result->metric_count == BENCH_METRICS)
+		return;
+	result->metrics[result->metric_count].unit = unit;
+	result->metrics[result->metric_count].value = value;
+	result->metrics[result->metric_count].per_run = per_run;
+	result->metric_count++;
+}
+
+// one run of the given number of iterations, false if it has crashed
+static bool run_once(const bench_t *bench, uint32_t iterations) {
+	pid_t pid;
+	int status;
+
+	memset(result, 0, sizeof(*result));
+	fflush(stdout);
+	pid = fork();
+	if(pid == 0) {
+		mock_reset();
+		bench->func(iterations);
+		exit(0);
+	}
+	waitpid(pid, &status, 0);
+	return WIFEXITED(status) && !WEXITSTATUS(status);
+}
+
+static bool run(const bench_t *bench) {
+	uint32_t iterations = 1;
+	uint64_t elapsed;
+	int i;
+
+	for(;;) {
+		if(!run_once(bench, iterations))
+			return false;
+		elapsed = result->elapsed;
+		if(elapsed >= BENCH_MIN_NS || iterations >= BENCH_MAX)
+			break;
+		// aim a little past the minimum from the last run, at most a hundredfold
+		iterations = elapsed ? MIN(iterations * 100ull, BENCH_MIN_NS * 12 / 10 * iterations / elapsed + 1) : iterations * 100;
+		iterations = MIN(iterations, BENCH_MAX);
+	}
+
+	printf("%-32s %10u %12.1f ns/op", bench->name, iterations, (double)elapsed / iterations);
+	for(i=0;i<result->metric_count;i++)
+		printf(" %12.2f %s", result->metrics[i].per_run ? result->metrics[i].value : result->metrics[i].value / iterations,
+		       result->metrics[i].unit);
+	printf("\n");
+	return true;
+}
+
+int main(int argc, char **argv) {
+	int i;
+	int j;
+	int failed = 0;
+
+	result = mmap(NULL, sizeof(*result), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(result == MAP_FAILED) {
+		perror("mmap");
+		return 2;
+	}
+
+	for(i=0;i<bench_count;i++) {
+		for(j=1;j<argc;j++) {
+			if(strstr(benches[i].name, argv[j]))
+				break;
+		}
+		if(argc > 1 && j == argc)
+			continue;
+
+		if(!run(&benches[i])) {
+			printf("%-32s failed\n", benches[i].name);
+			failed++;
+		}
+	}
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,56 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Micro-benchmark harness for the host build. A benchmark registered with BENCH(name)
+// is called with an iteration count, sets up what it needs, and times only the loop
+// between bench_start() and bench_stop(). The harness raises the count until a run
+// takes long enough to measure, and reports the time per iteration. Host times are no
+// AVR cycle counts, but they compare the alternatives of a change on the same machine.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+#include "Mock/mock.h"
+
+typedef void (*bench_func_t)(uint32_t iterations);
+
+void bench_register(const char *name, bench_func_t func);
+
+void bench_start(void);
+void bench_stop(void);
+
+// adds a figure to the report line of the benchmark, per iteration unless per_run
+void bench_metric(const char *unit, double value, bool per_run);
+
+#define BENCH(name) \
+	static void bench_##name(uint32_t iterations); \
+	__attribute__((constructor)) static void bench_register_##name(void) { \
+		bench_register(#name, bench_##name); \
+	} \
+	static void bench_##name(uint32_t iterations)
+
+#endif
@@ -0,0 +1,182 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+#include "device.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include <util/crc16.h>
+
+#define DEVICE_STACK	(256 * 1024)
+
+int webradio_main(void);
+
+static ucontext_t test_context;
+static ucontext_t device_context;
+static uint8_t sequence;
+
+static void device_sleep(void) {
+	swapcontext(&device_context, &test_context);
+}
+
+static void device_main(void) {
+	webradio_main();
+	fprintf(stderr, "the main loop has returned\n");
+	abort();
+}
+
+void device_boot(void) {
+	getcontext(&device_context);
+	device_context.uc_stack.ss_sp = malloc(DEVICE_STACK);
+	device_context.uc_stack.ss_size = DEVICE_STACK;
+	device_context.uc_link = 0;
+	makecontext(&device_context, device_main, 0);
+
+	mock_on_sleep(device_sleep);
+	sequence = 0;
+	device_run();
+}
+
+void device_run(void) {
+	swapcontext(&test_context, &device_context);
+
+	// display transfers take well under a tick, finish them before the next one
+	if(!mock_spi_interrupt())
+		return;
+	do {
+		SPI_STC_vect();
+	} while(mock_spi_interrupt());
+	swapcontext(&test_context, &device_context);
+}
+
+void device_tick(uint16_t ms) {
+	while(ms--) {
+		TIMER0_COMPA_vect();
+		device_run();
+	}
+}
+
+void device_connect(void) {
+	RadioState_t state;
+
+	mock_usb_configure();
+	device_run();
+	device_state(&state);
+}
+
+void device_report(uint8_t *report, uint8_t sequence, const uint8_t *commands, uint8_t length) {
+	uint8_t i;
+	uint8_t crc = 0;
+
+	memset(report, 0, GENERIC_REPORT_SIZE);
+	report[PROTOCOL_OFFSET_VERSION] = PROTOCOL_VERSION;
+	report[PROTOCOL_OFFSET_SEQUENCE] = sequence;
+	memcpy(&report[PROTOCOL_OFFSET_COMMANDS], commands, length);
+	for(i=0;i<PROTOCOL_OFFSET_CRC;i++)
+		crc = _crc8_ccitt_update(crc, report[i]);
+	report[PROTOCOL_OFFSET_CRC] = crc;
+}
+
+bool device_command(const uint8_t *commands, uint8_t length) {
+	uint8_t report[GENERIC_REPORT_SIZE];
+	uint8_t offset;
+
+	device_report(report, ++sequence, commands, length);
+	for(offset=0;offset<GENERIC_REPORT_SIZE;offset+=GENERIC_EPSIZE) {
+		if(!mock_usb_out(GENERIC_OUT_EPADDR, &report[offset], MIN(GENERIC_EPSIZE, GENERIC_REPORT_SIZE - offset)))
+			return false;
+	}
+	device_run();
+	return true;
+}
+
+bool device_command_control(const uint8_t *commands, uint8_t length) {
+	uint8_t report[GENERIC_REPORT_SIZE];
+	USB_Request_Header_t request = {
+		.bmRequestType = REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE,
+		.bRequest = HID_REQ_SetReport,
+		.wValue = (HID_REPORT_ITEM_Out + 1) << 8,
+		.wIndex = INTERFACE_ID_GenericHID,
+		.wLength = GENERIC_REPORT_SIZE,
+	};
+	int result;
+
+	device_report(report, ++sequence, commands, length);
+	result = mock_usb_control(&request, report);
+	device_run();
+	return result == GENERIC_REPORT_SIZE;
+}
+
+bool device_state(RadioState_t *state) {
+	uint8_t *data = (uint8_t *)state;
+	uint8_t offset = 0;
+	int length;
+
+	while(offset < sizeof(RadioState_t)) {
+		length = mock_usb_in(GENERIC_IN_EPADDR, &data[offset]);
+		if(length < 0)
+			return false;
+		offset += length;
+	}
+	return true;
+}
+
+bool device_feature_get(uint8_t page, FeatureReport_t *report) {
+	USB_Request_Header_t request = {
+		.bmRequestType = REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE,
+		.bRequest = HID_REQ_SetReport,
+		.wValue = (HID_REPORT_ITEM_Feature + 1) << 8,
+		.wIndex = INTERFACE_ID_GenericHID,
+		.wLength = 1,
+	};
+
+	// the page is built by the main loop once it has been selected
+	if(mock_usb_control(&request, &page) != 1)
+		return false;
+	device_run();
+
+	request.bmRequestType = REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE;
+	request.bRequest = HID_REQ_GetReport;
+	request.wLength = sizeof(FeatureReport_t);
+	return mock_usb_control(&request, report) == sizeof(FeatureReport_t);
+}
+
+bool device_feature_set(const FeatureReport_t *report) {
+	USB_Request_Header_t request = {
+		.bmRequestType = REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE,
+		.bRequest = HID_REQ_SetReport,
+		.wValue = (HID_REPORT_ITEM_Feature + 1) << 8,
+		.wIndex = INTERFACE_ID_GenericHID,
+		.wLength = sizeof(FeatureReport_t),
+	};
+
+	if(mock_usb_control(&request, (void *)report) != sizeof(FeatureReport_t))
+		return false;
+	device_run();
+	return true;
+}
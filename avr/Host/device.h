@@ -0,0 +1,63 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// The whole firmware on the host mocks, driven as the USB host and the front panel
+// would. The firmware's main loop runs as a coroutine of the test: it is resumed
+// after every interrupt the test raises, and hands back when it goes to sleep.
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Mock/mock.h"
+
+#include "WebRadio.h"
+
+// runs SetupHardware() and the main loop up to its first sleep
+void device_boot(void);
+// resumes the main loop until it sleeps again, display transfers started meanwhile are
+// sent as the SPI interrupt would
+void device_run(void);
+// lets the given number of 1ms timer ticks pass
+void device_tick(uint16_t ms);
+// attaches and configures the device, and takes the first state report
+void device_connect(void);
+
+// sends a command report on the interrupt OUT endpoint, or through SET_REPORT, with
+// the next sequence number and the CRC filled in, then runs the main loop
+bool device_command(const uint8_t *commands, uint8_t length);
+bool device_command_control(const uint8_t *commands, uint8_t length);
+// builds a command report with the given sequence number
+void device_report(uint8_t *report, uint8_t sequence, const uint8_t *commands, uint8_t length);
+
+// takes the next state report from the interrupt IN endpoint, false if there is none
+bool device_state(RadioState_t *state);
+// reads and writes the feature report, letting the main loop build or apply the page
+bool device_feature_get(uint8_t page, FeatureReport_t *report);
+bool device_feature_set(const FeatureReport_t *report);
+
+#endif
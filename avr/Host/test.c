@@ -0,0 +1,125 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Runs the registered tests, each in a child process with a time limit, and prints one
+// line per test. Arguments select the tests whose name contains one of them.
+
+#include "test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define TESTS			256
+#define TEST_TIMEOUT	10		// seconds
+
+typedef struct {
+	const char *file;
+	const char *name;
+	test_func_t func;
+} test_t;
+
+static test_t tests[TESTS];
+static int test_count;
+
+void test_register(const char *file, const char *name, test_func_t func) {
+	if(test_count == TESTS) {
+		fprintf(stderr, "too many tests, raise TESTS\n");
+		exit(2);
+	}
+	tests[test_count].file = file;
+	tests[test_count].name = name;
+	tests[test_count].func = func;
+	test_count++;
+}
+
+void test_fail(const char *file, int line, const char *message, long long expected, long long actual) {
+	fprintf(stderr, "    %s:%d: %s failed", file, line, message);
+	if(expected != 1 || actual != 0)
+		fprintf(stderr, " (expected %lld, got %lld)", expected, actual);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+static bool selected(const test_t *test, int argc, char **argv) {
+	int i;
+
+	if(argc < 2)
+		return true;
+	for(i=1;i<argc;i++) {
+		if(strstr(test->name, argv[i]) || strstr(test->file, argv[i]))
+			return true;
+	}
+	return false;
+}
+
+static bool run(const test_t *test) {
+	pid_t pid;
+	int status;
+
+	fflush(stdout);
+	pid = fork();
+	if(pid < 0) {
+		perror("fork");
+		exit(2);
+	}
+	if(pid == 0) {
+		alarm(TEST_TIMEOUT);
+		mock_reset();
+		test->func();
+		exit(0);
+	}
+
+	waitpid(pid, &status, 0);
+	if(WIFEXITED(status))
+		return WEXITSTATUS(status) == 0;
+	if(WIFSIGNALED(status))
+		fprintf(stderr, "    %s\n", WTERMSIG(status) == SIGALRM ? "timed out" : strsignal(WTERMSIG(status)));
+	return false;
+}
+
+int main(int argc, char **argv) {
+	int i;
+	int passed = 0;
+	int failed = 0;
+
+	for(i=0;i<test_count;i++) {
+		if(!selected(&tests[i], argc, argv))
+			continue;
+		if(run(&tests[i])) {
+			printf("PASS  %s\n", tests[i].name);
+			passed++;
+		} else {
+			printf("FAIL  %s (%s)\n", tests[i].name, tests[i].file);
+			failed++;
+		}
+	}
+
+	printf("%d passed, %d failed\n", passed, failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+//
+//  Copyright (C) 2017 Laszlo Hegedues <laszlo.hegedues [at] gmail [dot] com>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a 
+//  copy of this software and associated documentation files (the "Software"), 
+//  to deal in the Software without restriction, including without limitation 
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//  and/or sell copies of the Software, and to permit persons to whom the 
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in 
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL 
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
+//  DEALINGS IN THE SOFTWARE.
+//
+//
+//  Created by Laszlo Hegedues on 18.10.2026.
+//
+
+// Unit test runner for the host build. Tests are registered with TEST(name) from any
+// file in Test/, and each one runs in its own process on freshly reset mocks, so the
+// firmware's static state starts out as after a power-on reset.
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Mock/mock.h"
+
+typedef void (*test_func_t)(void);
+
+void test_register(const char *file, const char *name, test_func_t func);
+void test_fail(const char *file, int line, const char *message, long long expected, long long actual);
+
+#define TEST(name) \
+	static void test_##name(void); \
+	__attribute__((constructor)) static void test_register_##name(void) { \
+		test_register(__FILE__, #name, test_##name); \
+	} \
+	static void test_##name(void)
+
+#define CHECK(condition) do { \
+	if(!(condition)) \
+		test_fail(__FILE__, __LINE__, #condition, 1, 0); \
+} while(0)
+
+#define CHECK_EQ(expected, actual) do { \
+	long long expected_ = (expected); \
+	long long actual_ = (actual); \
+	if(expected_ != actual_) \
+		test_fail(__FILE__, __LINE__, #expected " == " #actual, expected_, actual_); \
+} while(0)
+
+#endif
@@ -0,0 +1,202 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2016.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2016  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Definitions of the command protocol carried by the generic HID OUT report.
+ *
+ *  Every report starts with the protocol version and a sequence number, followed by any number of commands, and ends
+ *  with a CRC-8 (polynomial 0x07, initial value zero) over all other bytes of the report. Each command is an opcode
+ *  and a payload length, followed by the payload. The commands end at the first \ref PROTOCOL_CMD_END opcode, or where
+ *  the next command header would overlap the CRC. Reports with a bad CRC or an unknown version are dropped as a whole,
+ *  as are reports which repeat the sequence number of the last accepted report. The device starts out with zero as
+ *  the last accepted sequence number, and returns to it whenever it is configured, so a host should start counting
+ *  from one.
+ *
+ *  The sequence number of the last accepted report, and a count of dropped reports and of unknown or rejected commands,
+ *  are returned in the generic HID IN report.
+ */
+
+#ifndef _PROTOCOL_H_
+#define _PROTOCOL_H_
+
+	/* Includes: */
+		#include <stdint.h>
+
+		#include <LUFA/Common/Common.h>
+
+		#include "Config/AppConfig.h"
+		#include "Driver/display.h"
+		#include "Driver/preset.h"
+
+	/* Macros: */
+		/** Version of the command protocol implemented by the device. */
+		#define PROTOCOL_VERSION              1
+
+		/** Offset of the protocol version in the report. */
+		#define PROTOCOL_OFFSET_VERSION       0
+
+		/** Offset of the sequence number in the report. */
+		#define PROTOCOL_OFFSET_SEQUENCE      1
+
+		/** Offset of the first command in the report. */
+		#define PROTOCOL_OFFSET_COMMANDS      2
+
+		/** Offset of the CRC-8 in the report, which is always the last byte. */
+		#define PROTOCOL_OFFSET_CRC           (GENERIC_REPORT_SIZE - 1)
+
+		/** Size of a command header, the opcode and the payload length. */
+		#define PROTOCOL_COMMAND_HEADER_SIZE  2
+
+		/** Opcode which ends the commands of a report, so the rest of the report may be left as zero. */
+		#define PROTOCOL_CMD_END              0x00
+
+		/** Opcode to set the board LEDs. The one byte payload holds one bit per LED, LED 1 in bit 0. */
+		#define PROTOCOL_CMD_SET_LEDS         0x01
+
+		/** Opcode to show text in a display field. The payload is the field number, the text flags and the text.
+		 *  The rest of the field is blanked.
+		 */
+		#define PROTOCOL_CMD_TEXT             0x02
+
+		/** Opcode to upload a title to be scrolled in a display field. The payload is the field number, the text
+		 *  flags, the scroll interval and the pause at the ends (both in units of \ref MARQUEE_TICK_MS), the
+		 *  scroll mode (\ref MARQUEE_WRAP or \ref MARQUEE_BOUNCE) and the text.
+		 */
+		#define PROTOCOL_CMD_MARQUEE          0x03
+
+		/** Opcode to select the capabilities page of the feature report, see \ref Capabilities_t. No payload. */
+		#define PROTOCOL_CMD_CAPABILITIES     0x04
+
+		/** Opcode to upload part of a station preset into the device's page cache. The payload is the preset number,
+		 *  the offset within the record (little endian) and the record bytes. A preset is uploaded with as many of these
+		 *  commands as needed, then written with \ref PROTOCOL_CMD_PRESET_COMMIT. The command is rejected while another
+		 *  preset is being uploaded or written, see the busy flag of \ref FEATURE_PAGE_PRESETS.
+		 */
+		#define PROTOCOL_CMD_PRESET_WRITE     0x05
+
+		/** Opcode to write the preset uploaded by \ref PROTOCOL_CMD_PRESET_WRITE to the Dataflash. The payload is the
+		 *  preset number.
+		 */
+		#define PROTOCOL_CMD_PRESET_COMMIT    0x06
+
+		/** Opcode to erase a station preset. The payload is the preset number. */
+		#define PROTOCOL_CMD_PRESET_ERASE     0x07
+
+		/** Opcode to keep the rendered content of a display field in the device's frame cache, so that it can be shown
+		 *  again with \ref PROTOCOL_CMD_FRAME_SHOW. The payload is the handle chosen by the host and the field number.
+		 *  The least recently used frame is dropped to make room, and all frames are dropped when the device is
+		 *  configured.
+		 */
+		#define PROTOCOL_CMD_FRAME_STORE      0x08
+
+		/** Opcode to show a frame from the frame cache in the field it was stored from. The payload is the handle. The
+		 *  command is rejected if the frame is no longer cached, and the host then sends the text again.
+		 */
+		#define PROTOCOL_CMD_FRAME_SHOW       0x09
+
+		/** Opcode to start an LED effect, which is then run by the device on its own. The payload is the LEDs to
+		 *  change (one bit per LED as for \ref PROTOCOL_CMD_SET_LEDS), the effect (a LEDFX_* value), the brightness,
+		 *  the effect time in milliseconds (little endian) and the blink pattern, see \ref ledfx_t.
+		 */
+		#define PROTOCOL_CMD_LED_EFFECT       0x0A
+
+		/** Opcode to choose what the rotary encoder controls. The payload is \ref PROTOCOL_KNOB_TUNE or
+		 *  \ref PROTOCOL_KNOB_VOLUME. The mode is kept across power cycles, and the knob only tunes until it is set.
+		 */
+		#define PROTOCOL_CMD_KNOB_MODE        0x0B
+
+		/** Knob mode, the steps are only reported in the device state block, for tuning and navigation. */
+		#define PROTOCOL_KNOB_TUNE            0
+
+		/** Knob mode, each detent is also sent as Volume Up or Volume Down on the Consumer Control interface. */
+		#define PROTOCOL_KNOB_VOLUME          1
+
+		/** Text flag, to indicate that the text is UTF-8 encoded rather than Latin-1. */
+		#define PROTOCOL_TEXT_UTF8            (1 << 0)
+
+		/** Text flag for \ref PROTOCOL_CMD_MARQUEE, to indicate that the text is appended to the title uploaded by
+		 *  the previous command, for titles which do not fit in a single report.
+		 */
+		#define PROTOCOL_TEXT_APPEND          (1 << 1)
+
+		/** Capability flag, the device renders text with \ref PROTOCOL_CMD_TEXT. */
+		#define CAPABILITY_TEXT               (1 << 0)
+
+		/** Capability flag, the device scrolls titles with \ref PROTOCOL_CMD_MARQUEE. */
+		#define CAPABILITY_MARQUEE            (1 << 1)
+
+		/** Capability flag, the device reports front panel keys and key gestures. */
+		#define CAPABILITY_KEYS               (1 << 2)
+
+		/** Capability flag, the device reports rotary encoder steps. */
+		#define CAPABILITY_ENCODER            (1 << 3)
+
+		/** Capability flag, the device has a Consumer Control interface for media keys. */
+		#define CAPABILITY_CONSUMER           (1 << 4)
+
+		/** Capability flag, the device has the display stream bulk interface. */
+		#define CAPABILITY_STREAM             (1 << 5)
+
+		/** Capability flag, the device exports input latency statistics in the feature report. */
+		#define CAPABILITY_LATENCY            (1 << 6)
+
+		/** Capability flag, the device stores station presets on its Dataflash. */
+		#define CAPABILITY_PRESETS            (1 << 7)
+
+		/** Capability flag, the device keeps rendered fields in a frame cache. */
+		#define CAPABILITY_FRAMES             (1 << 8)
+
+		/** Capability flag, the device dims the board LEDs and runs LED effects with \ref PROTOCOL_CMD_LED_EFFECT. */
+		#define CAPABILITY_LED_EFFECTS        (1 << 9)
+
+		/** Capability flag, the device exports the run time statistics of its tasks in the feature report. */
+		#define CAPABILITY_SCHEDULER          (1 << 10)
+
+		/** Capability flag, the knob can be made the volume control with \ref PROTOCOL_CMD_KNOB_MODE. */
+		#define CAPABILITY_KNOB_VOLUME        (1 << 11)
+
+	/* Type Defines: */
+		/** Type define for the capabilities page of the feature report, which describes the device to the host. */
+		typedef struct
+		{
+			uint8_t  ProtocolVersion; /**< \ref PROTOCOL_VERSION */
+			uint8_t  ReportSize; /**< Size of the generic HID input and output reports */
+			uint16_t Capabilities; /**< Mask of CAPABILITY_* flags */
+			uint8_t  DisplayOutputs; /**< Number of PT6524 segment outputs, each driving four commons */
+			uint8_t  FieldWidths[DISPLAY_FIELDS]; /**< Width of each display field in characters */
+			uint8_t  MarqueeLength; /**< Longest title kept by the marquee */
+			uint8_t  Keys; /**< Number of front panel keys */
+			uint8_t  Presets; /**< Number of station presets, zero if the Dataflash is missing */
+			uint16_t PresetSize; /**< Size of a preset record in bytes */
+			uint8_t  Frames; /**< Number of frames kept by the frame cache */
+		} ATTR_PACKED Capabilities_t;
+
+#endif
@@ -34,23 +34,125 @@
  *  is responsible for the initial application hardware configuration.
  */
 
+#define  INCLUDE_FROM_WEBRADIO_C
 #include "WebRadio.h"
 
+/** Device state block. This is the single copy of the state reported to the host, which is streamed directly into
+ *  the IN endpoint and the control endpoint without being copied into an intermediate report buffer.
+ */
+static RadioState_t RadioState;
+
+/** Flag to indicate that the device state block has changed since the last IN report was started. */
+static volatile bool RadioStateChanged;
+
+/** Offset within \ref RadioState of the next byte to be sent on the IN endpoint, zero if no report is in progress. */
+static uint8_t GenericReportINOffset;
+
+/** Events from the display driver interrupt to the main loop. */
+static event_queue_t DisplayEvents;
+
+/** Events from the key matrix scanner task to the main loop. */
+static event_queue_t KeyEvents;
+
+/** Events from the rotary encoder interrupt to the main loop. */
+static event_queue_t EncoderEvents;
+
+/** Gestures classified from the key events, collected one per IN report. */
+static event_queue_t GestureEvents;
+
+/** Feature report page selected by the last SET_REPORT request, returned by GET_REPORT requests. */
+static uint8_t FeaturePage;
+
+/** Settings page written by the host, which is applied from the main loop. */
+static FeatureReport_t FeatureWrite;
+
+/** Number of bytes of \ref FeatureWrite received from the host, zero once it has been applied. */
+static volatile uint8_t FeatureWriteSize;
+
+/** Selected feature report page as last built by the main loop, returned by GET_REPORT requests. */
+static FeatureReport_t FeatureSnapshot;
+
+/** Flag to indicate that \ref FeatureSnapshot has been read or another page selected, so it is built again. */
+static volatile bool FeatureSnapshotStale = true;
+
+/** Media keys of the front panel which are currently held, as CONSUMER_* report bits. */
+static uint8_t ConsumerKeys;
+
+/** Volume steps from the rotary encoder still to be sent on the Consumer Control interface, negative to turn down. */
+static volatile int8_t ConsumerVolume;
+
+/** Consumer Control report last sent to the host. */
+static uint8_t ConsumerReportSent;
+
+/** Media key sent on the Consumer Control interface for each front panel key, or zero for keys which are only reported
+ *  on the generic HID interface.
+ */
+static const uint8_t PROGMEM ConsumerKeyMap[BUTTONS_ROWS * BUTTONS_COLUMNS] =
+	{
+		CONSUMER_PLAY_PAUSE, CONSUMER_PREVIOUS, CONSUMER_NEXT, CONSUMER_MUTE,
+	};
+
+/** LED effect while the USB interface is enumerating. */
+static const ledfx_t LEDEffectEnumerating = {LEDFX_BREATHE, LEDFX_FULL, 1500, 0};
+
+/** LED effect while the USB interface is in an error state, a double blink. */
+static const ledfx_t LEDEffectError = {LEDFX_BLINK, LEDFX_FULL, 125, 0xA0};
+
+/** Station preset recalled by each front panel key, or \ref PRESET_NONE for keys without a preset. */
+static const uint8_t PROGMEM PresetKeyMap[BUTTONS_ROWS * BUTTONS_COLUMNS] =
+	{
+		PRESET_NONE, PRESET_NONE, PRESET_NONE, PRESET_NONE, 0, 1, 2, 3,
+	};
+
+/** Preset recalled from the front panel which is still being loaded from the Dataflash, or \ref PRESET_NONE. */
+static uint8_t PresetRecall = PRESET_NONE;
+
+/** Settings kept across power cycles in the EEPROM journal, saved whenever one of them changes. */
+static settings_t Settings;
+
+/** Preset and offset within its record returned by the presets page of the feature report. */
+static uint8_t  PresetReadPreset;
+static uint16_t PresetReadOffset;
+
+_Static_assert(sizeof(FeatureReport_t) == GENERIC_FEATURE_SIZE, "all settings pages fit into the feature report");
+
+/** Command reports from the interrupt OUT endpoint and from SET_REPORT requests. Commands are only run once the whole
+ *  report has arrived and its CRC has been checked, so each report is collected first, and then run from the main
+ *  loop so that commands never race the tasks which share the display and the preset store.
+ */
+static CommandSource_t InterruptCommands;
+static CommandSource_t ControlCommands;
+
+_Static_assert(!(COMMAND_REPORTS & (COMMAND_REPORTS - 1)) && (COMMAND_REPORTS <= EVENT_QUEUE_SIZE),
+               "the command report slots follow the event queue index");
 
 /** Main program entry point. This routine configures the hardware required by the application, then
- *  enters a loop to run the application tasks in sequence.
+ *  idles the CPU between interrupts, as all USB endpoints are serviced from the USB interrupt handlers.
  */
 int main(void)
 {
 	SetupHardware();
 
-	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+	ledfx_set_all(LEDMASK_USB_NOTREADY);
 	GlobalInterruptEnable();
 
 	for (;;)
 	{
-		HID_Task();
-		USB_USBTask();
+		/* Handle the events queued by the interrupt handlers, then run the periodic tasks which became due */
+		EventTask();
+		sched_run();
+
+		/* Sleep until the next interrupt has been serviced, unless a tick has elapsed or an event has been queued
+		 *  while the tasks were running */
+		GlobalInterruptDisable();
+		if (!(sched_pending()) && !(EventsPending()))
+		{
+			sleep_enable();
+			GlobalInterruptEnable();
+			sleep_cpu();
+			sleep_disable();
+		}
+		GlobalInterruptEnable();
 	}
 }
 
@@ -61,12 +163,239 @@ void SetupHardware(void)
 	MCUSR &= ~(1 << WDRF);
 	wdt_disable();
 
+	/* Disable the JTAG interface, which holds the key matrix rows on PF4 (TCK) and PF5 (TMS). The JTD bit only takes
+	   effect if it is written twice within four cycles */
+	MCUCR = (1 << JTD);
+	MCUCR = (1 << JTD);
+
 	/* Disable clock division */
 	clock_prescale_set(clock_div_1);
 
+	/* Keep the USB controller and timers running while the CPU is idle */
+	set_sleep_mode(SLEEP_MODE_IDLE);
+
 	/* Hardware Initialization */
 	LEDs_Init();
+	ledfx_init();
+	preset_init();
+	pt6524_init();
+	pt6524_set_callback(DisplayDone);
 	USB_Init();
+
+	/* Periodic tasks, all USB endpoints are serviced from the USB interrupt instead */
+	sched_init();
+	keys_init(&KeyEvents);
+	encoder_init(&EncoderEvents);
+	gesture_init(&GestureEvents);
+	sched_add(keys_scan, 1, 0, KEYS_TASK_BUDGET);
+	sched_add(DisplayTask, DISPLAY_TASK_PERIOD_MS, 0, DISPLAY_TASK_BUDGET);
+	sched_add(marquee_tick, MARQUEE_TICK_MS, 1, MARQUEE_TASK_BUDGET);
+	sched_add(GestureTask, GESTURE_TICK_MS, 1, GESTURE_TASK_BUDGET);
+	sched_add(PresetTask, PRESET_TASK_PERIOD_MS, 1, PRESET_TASK_BUDGET);
+	sched_add(settings_task, SETTINGS_TASK_PERIOD_MS, 2, SETTINGS_TASK_BUDGET);
+
+	LoadSettings();
+}
+
+/** Restores the settings saved before the last power cycle, so that the device starts up as the host left it without
+ *  waiting for the host to enumerate it.
+ */
+static void LoadSettings(void)
+{
+	/* Start out from the driver defaults, which are kept if nothing has been saved yet */
+	gesture_get_config(&Settings.gestures);
+	marquee_get_speed(&Settings.marquee_speed, &Settings.marquee_pause, &Settings.marquee_mode);
+	Settings.preset = PRESET_NONE;
+	Settings.knob_mode = PROTOCOL_KNOB_TUNE;
+
+	if (!(settings_load(&Settings)))
+	  return;
+
+	gesture_set_config(&Settings.gestures);
+	marquee_set_speed(Settings.marquee_speed, Settings.marquee_pause, Settings.marquee_mode);
+
+	/* Show the last station once the preset store has found the Dataflash */
+	if (Settings.preset < PRESET_COUNT)
+	  PresetRecall = Settings.preset;
+}
+
+/** Event task. This drains the event queues filled by the interrupt handlers, and is run on every wakeup. */
+static void EventTask(void)
+{
+	event_t Event;
+
+	while (event_get(&DisplayEvents, &Event) || event_get(&KeyEvents, &Event) || event_get(&EncoderEvents, &Event))
+	{
+		switch (Event.type)
+		{
+			case EVENT_DISPLAY_DONE:
+				/* Send the changes which were held back during the transfer right away, rather than on the next tick */
+				pt6524_commit();
+				break;
+
+			case EVENT_KEY_DOWN:
+			case EVENT_KEY_UP:
+				/* Report the debounced key state, the edge counter lets the host detect changes it has missed */
+				if (Event.type == EVENT_KEY_DOWN)
+				  RadioState.Keys |=  (BUTTONS_BUTTON1 << Event.data);
+				else
+				  RadioState.Keys &= ~(BUTTONS_BUTTON1 << Event.data);
+
+				RadioState.KeyEdges++;
+				gesture_key(&Event);
+				HID_NotifyStateChanged();
+
+				/* Media keys also go to the host's input layer directly */
+				if (pgm_read_byte(&ConsumerKeyMap[Event.data]))
+				{
+					if (Event.type == EVENT_KEY_DOWN)
+					  ConsumerKeys |=  pgm_read_byte(&ConsumerKeyMap[Event.data]);
+					else
+					  ConsumerKeys &= ~pgm_read_byte(&ConsumerKeyMap[Event.data]);
+
+					Consumer_NotifyChanged();
+				}
+
+				/* Preset keys show the stored station right away if it is cached, otherwise once it has been loaded */
+				if ((Event.type == EVENT_KEY_DOWN) && (pgm_read_byte(&PresetKeyMap[Event.data]) != PRESET_NONE))
+				{
+					PresetRecall = pgm_read_byte(&PresetKeyMap[Event.data]);
+
+					Settings.preset = PresetRecall;
+					settings_save(&Settings);
+
+					if (ShowPreset(PresetRecall))
+					  PresetRecall = PRESET_NONE;
+				}
+				break;
+
+			case EVENT_ENCODER:
+				/* The steps are summed by the encoder driver, and collected when the next report is started */
+				HID_NotifyStateChanged();
+
+				/* The knob is only the volume control as well if the host has asked for it, as it also tunes */
+				if (Settings.knob_mode != PROTOCOL_KNOB_VOLUME)
+				  break;
+
+				ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+				{
+					int16_t Volume = ConsumerVolume + (int8_t)Event.data;
+
+					ConsumerVolume = MAX(MIN(Volume, INT8_MAX), INT8_MIN);
+				}
+
+				Consumer_NotifyChanged();
+				break;
+		}
+	}
+
+	/* Run the command reports of each source in the order they have been received */
+	while (event_get(&InterruptCommands.Queue, &Event))
+	  ProcessCommandReport(InterruptCommands.Reports[Event.data]);
+
+	while (event_get(&ControlCommands.Queue, &Event))
+	  ProcessCommandReport(ControlCommands.Reports[Event.data]);
+
+	/* Apply a settings page written by the host, which shares its state with the tasks */
+	if (FeatureWriteSize)
+	{
+		ProcessFeatureReport(&FeatureWrite, FeatureWriteSize);
+
+		FeatureWriteSize     = 0;
+		FeatureSnapshotStale = true;
+	}
+
+	/* Build the page the host reads next, and hand it to the USB interrupt as a whole */
+	if (FeatureSnapshotStale)
+	{
+		FeatureReport_t FeatureReport;
+
+		FeatureSnapshotStale = false;
+		CreateFeatureReport(&FeatureReport);
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			FeatureSnapshot = FeatureReport;
+		}
+	}
+}
+
+/** Gesture task. This times held and released keys, and notifies the host of the gestures classified from them. */
+static void GestureTask(void)
+{
+	if (gesture_tick())
+	  HID_NotifyStateChanged();
+}
+
+/** Preset task. This runs the Dataflash transfers of the preset store, and shows a recalled preset once it has been
+ *  loaded.
+ */
+static void PresetTask(void)
+{
+	preset_task();
+
+	if ((PresetRecall != PRESET_NONE) && ShowPreset(PresetRecall))
+	  PresetRecall = PRESET_NONE;
+}
+
+/** Shows the name of a station preset and its number on the display, if the preset is in the page cache.
+ *
+ *  \param[in] Preset  Preset number, from zero
+ *
+ *  \return Boolean \c true if the preset has been shown, \c false if it is still being loaded
+ */
+static bool ShowPreset(const uint8_t Preset)
+{
+	uint8_t          Record[PRESET_NAME + PRESET_NAME_SIZE];
+	char             Number[4];
+	display_writer_t Writer;
+
+	if (!(preset_read(Preset, 0, Record, sizeof(Record))))
+	  return false;
+
+	/* An empty preset blanks the name */
+	uint8_t Length = Record[PRESET_NAME_LENGTH];
+
+	if (Length > PRESET_NAME_SIZE)
+	  Length = 0;
+
+	marquee_stop(DISPLAY_FIELD_TEXT);
+	display_text_begin(&Writer, DISPLAY_FIELD_TEXT, (Record[PRESET_FLAGS] & PRESET_UTF8));
+
+	for (uint8_t i = 0; i < Length; i++)
+	{
+		if (!(display_text_feed(&Writer, Record[PRESET_NAME + i])))
+		  break;
+	}
+
+	display_text_end(&Writer);
+
+	utoa(Preset + 1, Number, 10);
+	display_puts(DISPLAY_FIELD_PRESET, Number);
+	return true;
+}
+
+/** Checks the event queues filled by the interrupt handlers and tasks.
+ *
+ *  \return Boolean \c true if an event is waiting to be handled by \ref EventTask(), \c false otherwise
+ */
+static bool EventsPending(void)
+{
+	return (event_pending(&DisplayEvents) || event_pending(&KeyEvents) || event_pending(&EncoderEvents) ||
+	        event_pending(&InterruptCommands.Queue) || event_pending(&ControlCommands.Queue) ||
+	        FeatureWriteSize || FeatureSnapshotStale);
+}
+
+/** PT6524 transfer completion callback, called from the SPI interrupt. */
+static void DisplayDone(void)
+{
+	event_put(&DisplayEvents, EVENT_DISPLAY_DONE, 0);
+}
+
+/** Display refresh task. This sends all display changes made since the last tick in a single transfer. */
+static void DisplayTask(void)
+{
+	pt6524_commit();
 }
 
 /** Event handler for the USB_Connect event. This indicates that the device is enumerating via the status LEDs and
@@ -75,7 +404,8 @@ void SetupHardware(void)
 void EVENT_USB_Device_Connect(void)
 {
 	/* Indicate USB enumerating */
-	LEDs_SetAllLEDs(LEDMASK_USB_ENUMERATING);
+	UpdateLEDs(LEDMASK_USB_ENUMERATING);
+	ledfx_set(LEDMASK_USB_ENUMERATING, &LEDEffectEnumerating);
 }
 
 /** Event handler for the USB_Disconnect event. This indicates that the device is no longer connected to a host via
@@ -83,8 +413,23 @@ void EVENT_USB_Device_Connect(void)
  */
 void EVENT_USB_Device_Disconnect(void)
 {
+	/* Fall back to the crystal timebase */
+	USB_Device_DisableSOFEvents();
+
+	/* Nobody is left to commit a preset upload */
+	preset_abort();
+
 	/* Indicate USB not ready */
-	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+	UpdateLEDs(LEDMASK_USB_NOTREADY);
+}
+
+/** Event handler for the USB_Reset event. This is fired after the library has reconfigured the control endpoint on
+ *  a bus reset, and enables the SETUP interrupt so that control requests are serviced from \ref USB_COM_vect.
+ */
+void EVENT_USB_Device_Reset(void)
+{
+	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+	UEIENX |= (1 << RXSTPE);
 }
 
 /** Event handler for the USB_ConfigurationChanged event. This is fired when the host sets the current configuration
@@ -97,9 +442,53 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 	/* Setup HID Report Endpoints */
 	ConfigSuccess &= Endpoint_ConfigureEndpoint(GENERIC_IN_EPADDR, EP_TYPE_INTERRUPT, GENERIC_EPSIZE, 1);
 	ConfigSuccess &= Endpoint_ConfigureEndpoint(GENERIC_OUT_EPADDR, EP_TYPE_INTERRUPT, GENERIC_EPSIZE, 1);
+	ConfigSuccess &= Endpoint_ConfigureEndpoint(CONSUMER_IN_EPADDR, EP_TYPE_INTERRUPT, CONSUMER_EPSIZE, 1);
+
+	#if defined(DISPLAY_STREAM)
+	/* Setup the double banked display stream endpoint, so the host can fill one bank while the other is parsed */
+	ConfigSuccess &= Endpoint_ConfigureEndpoint(STREAM_OUT_EPADDR, EP_TYPE_BULK, STREAM_EPSIZE, 2);
+
+	Endpoint_SelectEndpoint(STREAM_OUT_EPADDR);
+	UEIENX |= (1 << RXOUTE);
+	#endif
+
+	/* Raise the endpoint interrupt when a report arrives from the host */
+	Endpoint_SelectEndpoint(GENERIC_OUT_EPADDR);
+	UEIENX |= (1 << RXOUTE);
+
+	/* Use the host's frame clock as the timebase */
+	USB_Device_EnableSOFEvents();
+
+	/* Frame handles are only valid for the host which stored them */
+	frames_flush();
+
+	/* Restart report transfers, and always give a newly configured host the current device state */
+	GenericReportINOffset  = 0;
+	InterruptCommands.Offset = 0;
+	ConsumerReportSent     = 0;
+
+	/* A new host starts counting its reports from one again, and gets no steps turned before it was there */
+	RadioState.CommandSequence = 0;
+	encoder_clear();
+
+	/* A preset upload left behind by the previous host will never be committed */
+	preset_abort();
+	HID_NotifyStateChanged();
+	Consumer_NotifyChanged();
 
 	/* Indicate endpoint configuration success or failure */
-	LEDs_SetAllLEDs(ConfigSuccess ? LEDMASK_USB_READY : LEDMASK_USB_ERROR);
+	UpdateLEDs(ConfigSuccess ? LEDMASK_USB_READY : LEDMASK_USB_ERROR);
+
+	if (!(ConfigSuccess))
+	  ledfx_set(LEDMASK_USB_ERROR, &LEDEffectError);
+}
+
+/** Event handler for the USB_StartOfFrame event. This is fired once per millisecond while the host is sending frames,
+ *  and locks the scheduler tick to the frame clock, so that display refreshes and reports line up with USB frames.
+ */
+void EVENT_USB_Device_StartOfFrame(void)
+{
+	sched_sof();
 }
 
 /** Event handler for the USB_ControlRequest event. This is used to catch and process control requests sent to
@@ -114,109 +503,599 @@ void EVENT_USB_Device_ControlRequest(void)
 		case HID_REQ_GetReport:
 			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
-				uint8_t GenericData[GENERIC_REPORT_SIZE];
-				CreateGenericHIDReport(GenericData);
+				/* The report type is sent one higher than the library's HID_ReportItemTypes_t values */
+				uint8_t ReportType = ((USB_ControlRequest.wValue >> 8) - 1);
 
 				Endpoint_ClearSETUP();
 
-				/* Write the report data to the control endpoint */
-				Endpoint_Write_Control_Stream_LE(&GenericData, sizeof(GenericData));
+				if (USB_ControlRequest.wIndex == INTERFACE_ID_Consumer)
+				{
+					/* Write the media keys last reported to the control endpoint */
+					Endpoint_Write_Control_Stream_LE(&ConsumerReportSent, sizeof(ConsumerReportSent));
+				}
+				else if (ReportType == HID_REPORT_ITEM_Feature)
+				{
+					FeatureReport_t FeatureReport;
+
+					/* Write the selected settings page as built by the main loop, which then builds it again */
+					ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+					{
+						FeatureReport = FeatureSnapshot;
+					}
+
+					FeatureSnapshotStale = true;
+					Endpoint_Write_Control_Stream_LE(&FeatureReport, sizeof(FeatureReport));
+				}
+				else
+				{
+					/* Write the device state block to the control endpoint */
+					Endpoint_Write_Control_Stream_LE(&RadioState, sizeof(RadioState));
+				}
+
 				Endpoint_ClearOUT();
 			}
 
 			break;
 		case HID_REQ_SetReport:
-			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE))
+			if ((USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE)) &&
+			    (USB_ControlRequest.wIndex == INTERFACE_ID_GenericHID))
 			{
-				uint8_t GenericData[GENERIC_REPORT_SIZE];
+				uint8_t  ReportType     = ((USB_ControlRequest.wValue >> 8) - 1);
+				uint16_t BytesRemaining = USB_ControlRequest.wLength;
+
+				/* The last settings page written is still waiting for the main loop, the request is stalled so that
+				 *  the host sends it again */
+				if ((ReportType == HID_REPORT_ITEM_Feature) && FeatureWriteSize)
+				  break;
 
 				Endpoint_ClearSETUP();
 
-				/* Read the report data from the control endpoint */
-				Endpoint_Read_Control_Stream_LE(&GenericData, sizeof(GenericData));
-				Endpoint_ClearIN();
+				if (ReportType == HID_REPORT_ITEM_Feature)
+				{
+					/* Settings pages are small, so read the whole report before it is queued to be applied */
+					memset(&FeatureWrite, 0, sizeof(FeatureWrite));
+					Endpoint_Read_Control_Stream_LE(&FeatureWrite, MIN(BytesRemaining, sizeof(FeatureWrite)));
+					Endpoint_ClearIN();
+
+					FeatureWriteSize = MIN(BytesRemaining, sizeof(FeatureWrite));
+					break;
+				}
+
+				/* Collect the report from the control endpoint FIFO, one packet at a time */
+				ControlCommands.Offset = 0;
+
+				while (BytesRemaining)
+				{
+					/* Give up on the report if the host has started a new request instead, or has gone away */
+					while (!(Endpoint_IsOUTReceived()))
+					{
+						if (Endpoint_IsSETUPReceived())
+						  return;
 
-				ProcessGenericHIDReport(GenericData);
+						if ((USB_DeviceState == DEVICE_STATE_Unattached) || (USB_DeviceState == DEVICE_STATE_Suspended))
+						  return;
+					}
+
+					BytesRemaining -= MIN(BytesRemaining, Endpoint_BytesInEndpoint());
+					ReadGenericHIDReport(&ControlCommands);
+					Endpoint_ClearOUT();
+				}
+
+				Endpoint_ClearStatusStage();
 			}
 
 			break;
 	}
 }
 
-/** Function to process the last received report from the host.
+/** Fills a feature report with the settings page selected by the host. This is run from \ref EventTask(), which hands
+ *  the page to the USB interrupt to be read.
  *
- *  \param[in] DataArray  Pointer to a buffer where the last received report has been stored
+ *  \param[out] Report  Feature report to fill
  */
-void ProcessGenericHIDReport(uint8_t* DataArray)
+static void CreateFeatureReport(FeatureReport_t* const Report)
 {
-	/*
-		This is where you need to process reports sent from the host to the device. This
-		function is called each time the host has sent a new report. DataArray is an array
-		holding the report sent from the host.
-	*/
+	memset(Report, 0, sizeof(FeatureReport_t));
+	Report->Page = FeaturePage;
+
+	switch (FeaturePage)
+	{
+		case FEATURE_PAGE_GESTURES:
+			gesture_get_config(&Report->Gestures);
+			break;
+		case FEATURE_PAGE_LATENCY:
+			latency_get(&Report->Latency);
+			break;
+		case FEATURE_PAGE_CAPABILITIES:
+			Report->Capabilities.ProtocolVersion = PROTOCOL_VERSION;
+			Report->Capabilities.ReportSize      = GENERIC_REPORT_SIZE;
+			Report->Capabilities.Capabilities    = (CAPABILITY_TEXT | CAPABILITY_MARQUEE | CAPABILITY_KEYS |
+			                                        CAPABILITY_ENCODER | CAPABILITY_CONSUMER | CAPABILITY_LATENCY |
+			                                        CAPABILITY_FRAMES | CAPABILITY_LED_EFFECTS | CAPABILITY_SCHEDULER |
+			                                        CAPABILITY_KNOB_VOLUME);
+			#if defined(DISPLAY_STREAM)
+			Report->Capabilities.Capabilities   |= CAPABILITY_STREAM;
+			#endif
+			Report->Capabilities.DisplayOutputs  = PT_DIGITS;
+			Report->Capabilities.MarqueeLength   = MARQUEE_LENGTH;
+			Report->Capabilities.Keys            = (BUTTONS_ROWS * BUTTONS_COLUMNS);
+			Report->Capabilities.PresetSize      = PRESET_SIZE;
+			Report->Capabilities.Frames          = FRAMES_COUNT;
 
-	uint8_t NewLEDMask = LEDS_NO_LEDS;
+			if (preset_present())
+			{
+				Report->Capabilities.Capabilities |= CAPABILITY_PRESETS;
+				Report->Capabilities.Presets       = PRESET_COUNT;
+			}
 
-	if (DataArray[0])
-	  NewLEDMask |= LEDS_LED1;
+			for (uint8_t Field = 0; Field < DISPLAY_FIELDS; Field++)
+			  Report->Capabilities.FieldWidths[Field] = display_field_width(Field);
+			break;
+		case FEATURE_PAGE_PRESETS:
+			Report->Presets.Preset = PresetReadPreset;
+			Report->Presets.Offset = PresetReadOffset;
+			Report->Presets.Ready  = preset_read(PresetReadPreset, PresetReadOffset, Report->Presets.Data,
+			                                     sizeof(Report->Presets.Data));
+			Report->Presets.Busy   = preset_busy();
+			break;
+		case FEATURE_PAGE_FRAMES:
+			frames_get_stats(&Report->Frames);
+			break;
+		case FEATURE_PAGE_SCHEDULER:
+			sched_get_stats(&Report->Scheduler);
+			break;
+	}
+}
 
-	if (DataArray[1])
-	  NewLEDMask |= LEDS_LED2;
+/** Applies a settings page written by the host, and selects it to be read back. A report which is shorter than
+ *  \ref FeatureReport_t only selects the page, so that the host can read a page without changing it. This is run
+ *  from \ref EventTask(), as the pages share their state with the tasks.
+ *
+ *  \param[in] Report      Feature report received from the host
+ *  \param[in] ReportSize  Number of bytes sent by the host
+ */
+static void ProcessFeatureReport(const FeatureReport_t* const Report,
+                                 const uint16_t ReportSize)
+{
+	FeaturePage = Report->Page;
 
-	if (DataArray[2])
-	  NewLEDMask |= LEDS_LED3;
+	if (ReportSize < sizeof(FeatureReport_t))
+	  return;
 
-	if (DataArray[3])
-	  NewLEDMask |= LEDS_LED4;
+	switch (Report->Page)
+	{
+		case FEATURE_PAGE_GESTURES:
+			gesture_set_config(&Report->Gestures);
 
-	LEDs_SetAllLEDs(NewLEDMask);
+			Settings.gestures = Report->Gestures;
+			settings_save(&Settings);
+			break;
+		case FEATURE_PAGE_LATENCY:
+			/* The statistics are read only, writing the page clears them */
+			latency_reset();
+			break;
+		case FEATURE_PAGE_PRESETS:
+			PresetReadPreset = Report->Presets.Preset;
+			PresetReadOffset = Report->Presets.Offset;
+			break;
+		case FEATURE_PAGE_FRAMES:
+			/* The counters are read only, writing the page clears them */
+			frames_reset_stats();
+			break;
+		case FEATURE_PAGE_SCHEDULER:
+			/* The statistics are read only, writing the page clears them */
+			sched_reset_stats();
+			break;
+	}
 }
 
-/** Function to create the next report to send back to the host at the next reporting interval.
+/** Sets the board LEDs, and mirrors the new LED state into the device state block reported to the host.
  *
- *  \param[out] DataArray  Pointer to a buffer where the next report data should be stored
+ *  \param[in] LEDMask  Mask of the board LEDs to turn on, all others are turned off
  */
-void CreateGenericHIDReport(uint8_t* DataArray)
+static void UpdateLEDs(const uint8_t LEDMask)
 {
-	/*
-		This is where you need to create reports to be sent to the host from the device. This
-		function is called each time the host is ready to accept a new report. DataArray is
-		an array to hold the report to the host.
-	*/
+	ledfx_set_all(LEDMask);
 
-	uint8_t CurrLEDMask = LEDs_GetLEDs();
+	RadioState.LEDs[0] = ((LEDMask & LEDS_LED1) ? 1 : 0);
+	RadioState.LEDs[1] = ((LEDMask & LEDS_LED2) ? 1 : 0);
+	RadioState.LEDs[2] = ((LEDMask & LEDS_LED3) ? 1 : 0);
+	RadioState.LEDs[3] = ((LEDMask & LEDS_LED4) ? 1 : 0);
 
-	DataArray[0] = ((CurrLEDMask & LEDS_LED1) ? 1 : 0);
-	DataArray[1] = ((CurrLEDMask & LEDS_LED2) ? 1 : 0);
-	DataArray[2] = ((CurrLEDMask & LEDS_LED3) ? 1 : 0);
-	DataArray[3] = ((CurrLEDMask & LEDS_LED4) ? 1 : 0);
+	HID_NotifyStateChanged();
 }
 
-void HID_Task(void)
+/** Reads the report bytes held in the currently selected endpoint's FIFO straight into the next free report slot of a
+ *  command report source. Reports larger than the endpoint are collected over several calls, one per received packet,
+ *  and each report is queued for \ref EventTask() once its last byte has arrived.
+ *
+ *  \param[in,out] Source  Command report source the FIFO belongs to
+ */
+static void ReadGenericHIDReport(CommandSource_t* const Source)
+{
+	uint8_t Offset        = Source->Offset;
+	uint8_t BytesInPacket = Endpoint_BytesInEndpoint();
+	uint8_t Slot          = (Source->Queue.head & (COMMAND_REPORTS - 1));
+
+	while (BytesInPacket--)
+	{
+		/* The slot of the report being run stays untouched, so one slot less than there are can be waiting. Slots
+		 *  can only become free while a report is received, so a report started in a free slot keeps it. */
+		if (!(Offset))
+		  Source->Dropping = (event_count(&Source->Queue) >= (COMMAND_REPORTS - 1));
+
+		uint8_t Byte = Endpoint_Read_8();
+
+		if (!(Source->Dropping))
+		  Source->Reports[Slot][Offset] = Byte;
+
+		if (++Offset != GENERIC_REPORT_SIZE)
+		  continue;
+
+		Offset = 0;
+
+		if (Source->Dropping)
+		{
+			Source->Queue.dropped++;
+			HID_NotifyStateChanged();
+		}
+		else
+		{
+			event_put(&Source->Queue, EVENT_COMMAND, Slot);
+			Slot = (Source->Queue.head & (COMMAND_REPORTS - 1));
+		}
+	}
+
+	Source->Offset = Offset;
+}
+
+/** Checks a command report, and runs its commands in order if it is intact, new and of a known protocol version. The
+ *  outcome is returned to the host in the next IN report.
+ *
+ *  \param[in] Report  Command report received from the host
+ */
+static void ProcessCommandReport(const uint8_t* const Report)
+{
+	uint8_t CRC    = 0;
+	uint8_t Offset = PROTOCOL_OFFSET_COMMANDS;
+
+	for (uint8_t i = 0; i < PROTOCOL_OFFSET_CRC; i++)
+	  CRC = _crc8_ccitt_update(CRC, Report[i]);
+
+	/* Drop corrupted reports, reports for other protocol versions and repeated reports as a whole */
+	if ((CRC != Report[PROTOCOL_OFFSET_CRC]) ||
+	    (Report[PROTOCOL_OFFSET_VERSION] != PROTOCOL_VERSION) ||
+	    (Report[PROTOCOL_OFFSET_SEQUENCE] == RadioState.CommandSequence))
+	{
+		RadioState.CommandErrors++;
+		HID_NotifyStateChanged();
+		return;
+	}
+
+	RadioState.CommandSequence = Report[PROTOCOL_OFFSET_SEQUENCE];
+
+	while ((Offset + PROTOCOL_COMMAND_HEADER_SIZE) <= PROTOCOL_OFFSET_CRC)
+	{
+		uint8_t Opcode = Report[Offset];
+		uint8_t Length = Report[Offset + 1];
+
+		if (Opcode == PROTOCOL_CMD_END)
+		  break;
+
+		Offset += PROTOCOL_COMMAND_HEADER_SIZE;
+
+		/* A payload running into the CRC means the rest of the report cannot be trusted */
+		if (Length > (PROTOCOL_OFFSET_CRC - Offset))
+		{
+			RadioState.CommandErrors++;
+			break;
+		}
+
+		if (!(ProcessCommand(Opcode, &Report[Offset], Length)))
+		  RadioState.CommandErrors++;
+
+		Offset += Length;
+	}
+
+	HID_NotifyStateChanged();
+}
+
+/** Runs a single command of a command report.
+ *
+ *  \param[in] Opcode   Command opcode, a PROTOCOL_CMD_* value
+ *  \param[in] Payload  Command payload
+ *  \param[in] Length   Length of the payload in bytes
+ *
+ *  \return Boolean \c true if the command is known, its payload is complete and it has been carried out, \c false otherwise
+ */
+static bool ProcessCommand(const uint8_t Opcode,
+                           const uint8_t* const Payload,
+                           const uint8_t Length)
+{
+	static const uint8_t ReportLEDMasks[] = {LEDS_LED1, LEDS_LED2, LEDS_LED3, LEDS_LED4};
+
+	switch (Opcode)
+	{
+		case PROTOCOL_CMD_SET_LEDS:
+		{
+			uint8_t NewLEDMask = LEDS_NO_LEDS;
+
+			if (Length < 1)
+			  return false;
+
+			for (uint8_t i = 0; i < sizeof(ReportLEDMasks); i++)
+			{
+				if (Payload[0] & (1 << i))
+				  NewLEDMask |= ReportLEDMasks[i];
+			}
+
+			UpdateLEDs(NewLEDMask);
+			return true;
+		}
+
+		case PROTOCOL_CMD_LED_EFFECT:
+		{
+			ledfx_t Effect;
+			uint8_t LEDMask = LEDS_NO_LEDS;
+
+			if (Length < 6)
+			  return false;
+
+			Effect.effect  = Payload[1];
+			Effect.level   = Payload[2];
+			Effect.time    = (Payload[3] | (Payload[4] << 8));
+			Effect.pattern = Payload[5];
+
+			for (uint8_t i = 0; i < sizeof(ReportLEDMasks); i++)
+			{
+				if (Payload[0] & (1 << i))
+				{
+					LEDMask |= ReportLEDMasks[i];
+					RadioState.LEDs[i] = (Effect.level ? 1 : 0);
+				}
+			}
+
+			ledfx_set(LEDMask, &Effect);
+			return true;
+		}
+
+		case PROTOCOL_CMD_TEXT:
+		{
+			display_writer_t Writer;
+
+			if (Length < 2)
+			  return false;
+
+			marquee_stop(Payload[0]);
+			display_text_begin(&Writer, Payload[0], (Payload[1] & PROTOCOL_TEXT_UTF8));
+
+			for (uint8_t i = 2; i < Length; i++)
+			{
+				if (!(display_text_feed(&Writer, Payload[i])))
+				  break;
+			}
+
+			display_text_end(&Writer);
+			return true;
+		}
+
+		case PROTOCOL_CMD_MARQUEE:
+			if ((Length < 5) || (Payload[0] >= DISPLAY_FIELDS))
+			  return false;
+
+			marquee_set_speed(Payload[2], Payload[3], Payload[4]);
+
+			/* Unchanged settings are not saved again, so a new title alone does not wear the EEPROM */
+			marquee_get_speed(&Settings.marquee_speed, &Settings.marquee_pause, &Settings.marquee_mode);
+			settings_save(&Settings);
+
+			marquee_begin(Payload[0], (Payload[1] & PROTOCOL_TEXT_UTF8), (Payload[1] & PROTOCOL_TEXT_APPEND));
+
+			for (uint8_t i = 5; i < Length; i++)
+			  marquee_feed(Payload[i]);
+
+			marquee_end();
+			return true;
+
+		case PROTOCOL_CMD_KNOB_MODE:
+			if ((Length < 1) || (Payload[0] > PROTOCOL_KNOB_VOLUME))
+			  return false;
+
+			Settings.knob_mode = Payload[0];
+			settings_save(&Settings);
+
+			/* Steps still to be sent would change the volume after the knob has been given back to tuning */
+			if (Settings.knob_mode != PROTOCOL_KNOB_VOLUME)
+			  ConsumerVolume = 0;
+			return true;
+
+		case PROTOCOL_CMD_CAPABILITIES:
+			FeaturePage          = FEATURE_PAGE_CAPABILITIES;
+			FeatureSnapshotStale = true;
+			return true;
+
+		case PROTOCOL_CMD_PRESET_WRITE:
+			if (Length < 3)
+			  return false;
+
+			return preset_write(Payload[0], (Payload[1] | (Payload[2] << 8)), &Payload[3], (Length - 3));
+
+		case PROTOCOL_CMD_PRESET_COMMIT:
+			if (Length < 1)
+			  return false;
+
+			return preset_commit(Payload[0]);
+
+		case PROTOCOL_CMD_PRESET_ERASE:
+			if (Length < 1)
+			  return false;
+
+			return preset_erase(Payload[0]);
+
+		case PROTOCOL_CMD_FRAME_STORE:
+			if (Length < 2)
+			  return false;
+
+			return frames_store(Payload[0], Payload[1]);
+
+		case PROTOCOL_CMD_FRAME_SHOW:
+		{
+			uint8_t Field;
+
+			if (Length < 1)
+			  return false;
+
+			Field = frames_show(Payload[0]);
+			if (Field == DISPLAY_FIELD_NONE)
+			  return false;
+
+			/* The frame replaces whatever was scrolling in its field */
+			marquee_stop(Field);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** Flags that the device state block has changed. This enables the generic HID IN endpoint interrupt, so that a new
+ *  report is sent from \ref HID_Task() once the endpoint bank is free. This may be called from both interrupt and main
+ *  loop context.
+ */
+void HID_NotifyStateChanged(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+		RadioStateChanged = true;
+
+		Endpoint_SelectEndpoint(GENERIC_IN_EPADDR);
+		UEIENX |= (1 << TXINE);
+
+		Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+	}
+}
+
+/** Flags that the media keys have changed. This enables the Consumer Control IN endpoint interrupt, so that a new
+ *  report is sent from \ref Consumer_Task() once the endpoint bank is free.
+ */
+void Consumer_NotifyChanged(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+		Endpoint_SelectEndpoint(CONSUMER_IN_EPADDR);
+		UEIENX |= (1 << TXINE);
+
+		Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+	}
+}
+
+/** Services the Consumer Control HID endpoint. This is called from \ref USB_COM_vect whenever the endpoint is free
+ *  while its interrupt is enabled by \ref Consumer_NotifyChanged(), and sends the held media keys. Each volume step
+ *  is sent as a press followed by a release, so that the host sees one key event per step.
+ */
+void Consumer_Task(void)
 {
 	/* Device must be connected and configured for the task to run */
 	if (USB_DeviceState != DEVICE_STATE_Configured)
 	  return;
 
-	Endpoint_SelectEndpoint(GENERIC_OUT_EPADDR);
+	Endpoint_SelectEndpoint(CONSUMER_IN_EPADDR);
 
-	/* Check to see if a packet has been sent from the host */
-	if (Endpoint_IsOUTReceived())
+	/* Check to see if the host is ready to accept another packet */
+	if (!(Endpoint_IsINReady()))
+	  return;
+
+	uint8_t Report = ConsumerKeys;
+
+	if (ConsumerVolume && !(ConsumerReportSent & (CONSUMER_VOLUME_UP | CONSUMER_VOLUME_DOWN)))
 	{
-		/* Check to see if the packet contains data */
-		if (Endpoint_IsReadWriteAllowed())
+		if (ConsumerVolume > 0)
+		{
+			Report |= CONSUMER_VOLUME_UP;
+			ConsumerVolume--;
+		}
+		else
 		{
-			/* Create a temporary buffer to hold the read in report from the host */
-			uint8_t GenericData[GENERIC_REPORT_SIZE];
+			Report |= CONSUMER_VOLUME_DOWN;
+			ConsumerVolume++;
+		}
+	}
+
+	/* Stop the endpoint interrupt once the host has the current state, and no volume steps are left */
+	if (Report == ConsumerReportSent)
+	{
+		if (!(ConsumerVolume))
+		  UEIENX &= ~(1 << TXINE);
+
+		return;
+	}
+
+	ConsumerReportSent = Report;
 
-			/* Read Generic Report Data */
-			Endpoint_Read_Stream_LE(&GenericData, sizeof(GenericData), NULL);
+	Endpoint_Write_8(Report);
+	Endpoint_ClearIN();
+}
 
-			/* Process Generic Report Data */
-			ProcessGenericHIDReport(GenericData);
+#if defined(DISPLAY_STREAM)
+/** Services the display stream endpoint. This is called from \ref USB_COM_vect whenever a packet has been received.
+ *  Each packet holds the number of the first PT6524 segment output to update, followed by one byte per two outputs
+ *  (the lower numbered output in the low nibble, COM1 in bit 0). The segments are written straight from the endpoint
+ *  FIFO into the display back buffer, and a packet is applied as a whole before the next display refresh.
+ */
+void Stream_Task(void)
+{
+	/* Device must be connected and configured for the task to run */
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return;
+
+	Endpoint_SelectEndpoint(STREAM_OUT_EPADDR);
+
+	/* Drain both banks if the host has filled them */
+	while (Endpoint_IsOUTReceived())
+	{
+		uint8_t BytesInPacket = Endpoint_BytesInEndpoint();
+
+		if (BytesInPacket)
+		{
+			uint8_t Output = Endpoint_Read_8();
+
+			/* Anything past the last output is dropped with the rest of the bank */
+			while (--BytesInPacket && (Output < PT_DIGITS))
+			{
+				uint8_t Outputs = Endpoint_Read_8();
+
+				pt6524_set_digit(Output++, (Outputs & 0x0F));
+				pt6524_set_digit(Output++, (Outputs >> 4));
+			}
 		}
 
-		/* Finalize the stream transfer to send the last packet */
+		Endpoint_ClearOUT();
+	}
+}
+#endif
+
+/** Services the generic HID endpoints. This is called from \ref USB_COM_vect whenever a report has been received on
+ *  the OUT endpoint, or the IN endpoint is free while its interrupt is enabled by \ref HID_NotifyStateChanged().
+ */
+void HID_Task(void)
+{
+	/* Device must be connected and configured for the task to run */
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return;
+
+	Endpoint_SelectEndpoint(GENERIC_OUT_EPADDR);
+
+	/* Check to see if a packet has been sent from the host */
+	if (Endpoint_IsOUTReceived())
+	{
+		/* Collect the packet straight from the endpoint FIFO */
+		ReadGenericHIDReport(&InterruptCommands);
+
+		/* Release the endpoint bank for the next packet */
 		Endpoint_ClearOUT();
 	}
 
@@ -225,17 +1104,82 @@ void HID_Task(void)
 	/* Check to see if the host is ready to accept another packet */
 	if (Endpoint_IsINReady())
 	{
-		/* Create a temporary buffer to hold the report to send to the host */
-		uint8_t GenericData[GENERIC_REPORT_SIZE];
+		/* Only start a new report if the device state has changed, otherwise leave the endpoint bank empty so that the
+		   host is NAKed, and stop the endpoint interrupt until the state changes again */
+		if (!(GenericReportINOffset))
+		{
+			if (!(RadioStateChanged))
+			{
+				UEIENX &= ~(1 << TXINE);
+				return;
+			}
+
+			/* Steps beyond the range of a report, and further gestures, are left for the next one */
+			event_t Gesture;
 
-		/* Create Generic Report Data */
-		CreateGenericHIDReport(GenericData);
+			if (!(event_get(&GestureEvents, &Gesture)))
+			  Gesture.type = Gesture.data = 0;
+
+			RadioState.Gesture         = Gesture.type;
+			RadioState.GestureKey      = Gesture.data;
+			RadioState.Encoder         = encoder_take();
+			RadioState.Frame           = USB_Device_GetFrameNumber();
+			RadioState.CommandsDropped = (InterruptCommands.Queue.dropped + ControlCommands.Queue.dropped);
+			RadioStateChanged          = (encoder_pending() || event_pending(&GestureEvents));
+
+			/* Time the inputs carried by this report until its last packet has been sent */
+			latency_start();
+			RadioState.Sequence++;
+		}
 
-		/* Write Generic Report Data */
-		Endpoint_Write_Stream_LE(&GenericData, sizeof(GenericData), NULL);
+		/* Fill one endpoint bank straight from the device state block, the rest follows on the next interrupts */
+		const uint8_t* StateData     = (const uint8_t*)&RadioState + GenericReportINOffset;
+		uint8_t        BytesInPacket = MIN(GENERIC_EPSIZE, sizeof(RadioState) - GenericReportINOffset);
 
-		/* Finalize the stream transfer to send the last packet */
+		GenericReportINOffset += BytesInPacket;
+		if (GenericReportINOffset == sizeof(RadioState))
+		  GenericReportINOffset = 0;
+
+		while (BytesInPacket--)
+		  Endpoint_Write_8(*(StateData++));
+
+		/* Send the packet to the host */
 		Endpoint_ClearIN();
+
+		if (!(GenericReportINOffset))
+		  latency_done();
 	}
 }
 
+/** USB endpoint interrupt handler. This takes the place of the library's handler (which only services the control
+ *  endpoint when INTERRUPT_CONTROL_ENDPOINT is set), and services the generic HID endpoints, the Consumer Control
+ *  endpoint, the display stream endpoint and the control endpoint. As in the library, control requests are processed with interrupts enabled and further SETUP interrupts
+ *  masked, since a control transfer may span several host transactions.
+ */
+ISR(USB_COM_vect, ISR_BLOCK)
+{
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+	HID_Task();
+	Consumer_Task();
+
+	#if defined(DISPLAY_STREAM)
+	Stream_Task();
+	#endif
+
+	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+
+	if (Endpoint_IsSETUPReceived() && (UEIENX & (1 << RXSTPE)))
+	{
+		UEIENX &= ~(1 << RXSTPE);
+
+		GlobalInterruptEnable();
+		USB_Device_ProcessControlRequest();
+		GlobalInterruptDisable();
+
+		Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+		UEIENX |= (1 << RXSTPE);
+	}
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+}
@@ -41,16 +41,40 @@
 		#include <avr/wdt.h>
 		#include <avr/power.h>
 		#include <avr/interrupt.h>
+		#include <avr/sleep.h>
+		#include <util/atomic.h>
+		#include <util/crc16.h>
 		#include <stdbool.h>
+		#include <stdlib.h>
 		#include <string.h>
 
 		#include "Descriptors.h"
+		#include "Protocol.h"
 		#include "Config/AppConfig.h"
+		#include "Driver/pt6524.h"
+		#include "Driver/display.h"
+		#include "Driver/marquee.h"
+		#include "Driver/scheduler.h"
+		#include "Driver/event.h"
+		#include "Driver/keys.h"
+		#include "Driver/encoder.h"
+		#include "Driver/gesture.h"
+		#include "Driver/latency.h"
+		#include "Driver/preset.h"
+		#include "Driver/settings.h"
+		#include "Driver/frames.h"
+		#include "Driver/ledfx.h"
 
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
+		#include <LUFA/Drivers/Board/Buttons.h>
 		#include <LUFA/Platform/Platform.h>
 
+	/* Preprocessor Checks: */
+		#if defined(INTERRUPT_CONTROL_ENDPOINT)
+			#error INTERRUPT_CONTROL_ENDPOINT must not be set, all endpoints are serviced by the application USB_COM_vect handler.
+		#endif
+
 	/* Macros: */
 		/** LED mask for the library LED driver, to indicate that the USB interface is not ready. */
 		#define LEDMASK_USB_NOTREADY      LEDS_LED1
@@ -64,18 +88,140 @@
 		/** LED mask for the library LED driver, to indicate that an error has occurred in the USB interface. */
 		#define LEDMASK_USB_ERROR        (LEDS_LED1 | LEDS_LED3)
 
+		/** Feature report page holding the gesture timing, see \ref gesture_config_t. */
+		#define FEATURE_PAGE_GESTURES      0
+
+		/** Feature report page holding the input to report latency statistics, see \ref latency_stats_t. Keys are
+		 *  timed from the first scan which saw them change, including the debounce. Writing the page resets the
+		 *  statistics.
+		 */
+		#define FEATURE_PAGE_LATENCY       1
+
+		/** Feature report page describing the device, see \ref Capabilities_t. */
+		#define FEATURE_PAGE_CAPABILITIES  2
+
+		/** Feature report page to download station presets, see \ref PresetPage_t. Writing the page sets the preset
+		 *  and offset to be read.
+		 */
+		#define FEATURE_PAGE_PRESETS       3
+
+		/** Feature report page holding the frame cache hit and miss counters, see \ref frames_stats_t. Writing the page
+		 *  resets the counters.
+		 */
+		#define FEATURE_PAGE_FRAMES        4
+
+		/** Feature report page holding the run time statistics of the periodic tasks, see \ref sched_stats_t. The
+		 *  tasks are numbered in the order \ref SetupHardware() adds them: key scan, display refresh, marquee, gestures,
+		 *  presets and settings. Reading the page clears the overrun flags, writing it resets the statistics.
+		 */
+		#define FEATURE_PAGE_SCHEDULER     5
+
+		/** Number of command report slots of each report source. One report is run by \ref EventTask() while the
+		 *  others wait, reports arriving while all slots are taken are dropped and counted.
+		 */
+		#define COMMAND_REPORTS            2
+
+	/* Type Defines: */
+		/** Type define for the device state block, which is sent to the host as-is as the generic HID IN report. */
+		typedef struct
+		{
+			uint8_t LEDs[4]; /**< On/off state of board LEDs 1 to 4, one byte per LED */
+			uint8_t Keys; /**< Debounced state of the front panel keys, one bit per key as in \ref BUTTONS_BUTTON1 */
+			uint8_t KeyEdges; /**< Number of key presses and releases, wrapping */
+			int8_t  Encoder; /**< Rotary encoder steps since the previous report, accelerated when turned quickly */
+			uint8_t Gesture; /**< Key gesture classified by the device, a GESTURE_* value, or zero if none */
+			uint8_t GestureKey; /**< Key number of \ref Gesture */
+			uint16_t Frame; /**< USB frame number in which the report was started, so the host can place it on its own clock */
+			uint8_t CommandSequence; /**< Sequence number of the last command report accepted, see Protocol.h */
+			uint8_t CommandErrors; /**< Number of command reports dropped and unknown or rejected commands skipped, wrapping */
+			uint8_t CommandsDropped; /**< Number of intact command reports dropped because the device was still running earlier ones, wrapping */
+			uint8_t Reserved[GENERIC_REPORT_SIZE - 15]; /**< Reserved for future use, always zero */
+			uint8_t Sequence; /**< Report sequence number, incremented for each IN report so the host can detect lost reports */
+		} ATTR_PACKED RadioState_t;
+
+		_Static_assert(sizeof(RadioState_t) == GENERIC_REPORT_SIZE, "the reserved bytes pad the state block to the report size");
+
+		/** Type define for a source of command reports, the interrupt OUT endpoint or SET_REPORT requests. Each source
+		 *  collects its reports in its own slots from the USB interrupt, and queues the complete ones to be run from
+		 *  the main loop.
+		 */
+		typedef struct
+		{
+			uint8_t       Offset; /**< Offset within the report being received of its next byte */
+			bool          Dropping; /**< The report being received is dropped, as all slots were taken when it started */
+			event_queue_t Queue; /**< \ref EVENT_COMMAND events of the reports waiting to be run */
+			uint8_t       Reports[COMMAND_REPORTS][GENERIC_REPORT_SIZE]; /**< Complete reports, indexed by the event data */
+		} CommandSource_t;
+
+		/** Type define for the presets page of the feature report, which returns part of a station preset record. A
+		 *  record which is not in the device's page cache is loaded when the page is read, so the host reads the page
+		 *  again until \ref Ready is set.
+		 */
+		typedef struct
+		{
+			uint8_t  Preset; /**< Preset number, from zero */
+			uint16_t Offset; /**< Offset of \ref Data within the record */
+			uint8_t  Ready; /**< Non-zero if \ref Data holds the record, zero while it is being loaded */
+			uint8_t  Busy; /**< Non-zero while an uploaded record is being written to the Dataflash */
+			uint8_t  Data[GENERIC_FEATURE_SIZE - 6]; /**< Record bytes from \ref Offset */
+		} ATTR_PACKED PresetPage_t;
+
+		/** Type define for the feature report, which reads and writes one page of device settings at a time. Writing a
+		 *  page also selects it to be read back.
+		 */
+		typedef struct
+		{
+			uint8_t Page; /**< Settings page, a FEATURE_PAGE_* value */
+
+			union
+			{
+				gesture_config_t Gestures; /**< \ref FEATURE_PAGE_GESTURES */
+				latency_stats_t  Latency; /**< \ref FEATURE_PAGE_LATENCY */
+				Capabilities_t   Capabilities; /**< \ref FEATURE_PAGE_CAPABILITIES */
+				PresetPage_t     Presets; /**< \ref FEATURE_PAGE_PRESETS */
+				frames_stats_t   Frames; /**< \ref FEATURE_PAGE_FRAMES */
+				sched_stats_t    Scheduler; /**< \ref FEATURE_PAGE_SCHEDULER */
+				uint8_t          Data[GENERIC_FEATURE_SIZE - 1];
+			} ATTR_PACKED;
+		} ATTR_PACKED FeatureReport_t;
+
 	/* Function Prototypes: */
 		void SetupHardware(void);
 		void HID_Task(void);
+		void HID_NotifyStateChanged(void);
+		void Consumer_Task(void);
+		void Consumer_NotifyChanged(void);
+
+		#if defined(DISPLAY_STREAM)
+			void Stream_Task(void);
+		#endif
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
+		void EVENT_USB_Device_Reset(void);
 		void EVENT_USB_Device_ConfigurationChanged(void);
 		void EVENT_USB_Device_ControlRequest(void);
 		void EVENT_USB_Device_StartOfFrame(void);
 
-		void ProcessGenericHIDReport(uint8_t* DataArray);
-		void CreateGenericHIDReport(uint8_t* DataArray);
+		#if defined(INCLUDE_FROM_WEBRADIO_C)
+			static void UpdateLEDs(const uint8_t LEDMask);
+			static void LoadSettings(void);
+			static void EventTask(void);
+			static bool EventsPending(void);
+			static void GestureTask(void);
+			static void PresetTask(void);
+			static bool ShowPreset(const uint8_t Preset);
+			static void CreateFeatureReport(FeatureReport_t* const Report);
+			static void ProcessFeatureReport(const FeatureReport_t* const Report,
+			                                 const uint16_t ReportSize);
+			static void DisplayDone(void);
+			static void DisplayTask(void);
+			static void ReadGenericHIDReport(CommandSource_t* const Source);
+			static void ProcessCommandReport(const uint8_t* const Report);
+			static bool ProcessCommand(const uint8_t Opcode,
+			                           const uint8_t* const Payload,
+			                           const uint8_t Length);
+		#endif
 
 #endif
 